@@ -0,0 +1,168 @@
+/**
+ * Measures the wake-up latency of the EventTrigger, the jitter of the NotifyTimer
+ * and the cost of the ITrigger methods under contention. All results are printed as
+ * percentiles in microseconds, so runs before and after a change can be compared.
+ *
+ * Usage: event_handling-bench [seconds per timer rate, default 1]
+ */
+#include <essentials/EventTrigger.h>
+#include <essentials/LatencyHistogram.h>
+#include <essentials/NotifyTimer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+void printHeader()
+{
+    printf("%-40s %10s %10s %10s %10s %10s %10s %10s\n", "benchmark", "count", "mean[us]", "p50[us]", "p90[us]", "p99[us]", "p99.9[us]", "max[us]");
+}
+
+void printResult(const std::string& name, const essentials::HistogramSnapshot& snapshot)
+{
+    printf("%-40s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", name.c_str(), static_cast<unsigned long long>(snapshot.count),
+            snapshot.getMean() / 1000.0, snapshot.getPercentile(50) / 1000.0, snapshot.getPercentile(90) / 1000.0,
+            snapshot.getPercentile(99) / 1000.0, snapshot.getPercentile(99.9) / 1000.0, snapshot.max / 1000.0);
+}
+
+/**
+ * A thread waiting on its own condition variable, which is registered at the trigger.
+ */
+class Waiter
+{
+public:
+    Waiter(essentials::EventTrigger& trigger, std::atomic<int>& woken, std::atomic<bool>& running)
+            : _trigger(trigger)
+            , _woken(woken)
+            , _running(running)
+    {
+        _trigger.registerCV(&_cv);
+        _thread = std::thread(&Waiter::run, this);
+    }
+    void join() { _thread.join(); }
+
+private:
+    void run()
+    {
+        // parks right away, so that the latency of a sleeping waiter is measured
+        essentials::AdaptiveWaitPolicy policy(0, 0, 0);
+        std::unique_lock<std::mutex> lck(_mtx);
+        while (true) {
+            _trigger.waitForNotify(&_cv, lck, policy);
+            if (!_running) {
+                return;
+            }
+            _trigger.recordWakeUp();
+            _trigger.setNotifyCalled(&_cv, false);
+            _woken++;
+        }
+    }
+
+    essentials::EventTrigger& _trigger;
+    std::atomic<int>& _woken;
+    std::atomic<bool>& _running;
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::thread _thread;
+};
+
+void benchmarkTriggerWakeUp(int waiterCount, int rounds)
+{
+    essentials::EventTrigger trigger;
+    trigger.enableStatistics();
+    std::atomic<int> woken(0);
+    std::atomic<bool> running(true);
+    std::vector<std::unique_ptr<Waiter>> waiters;
+    for (int i = 0; i < waiterCount; i++) {
+        waiters.push_back(std::make_unique<Waiter>(trigger, woken, running));
+    }
+
+    for (int round = 1; round <= rounds; round++) {
+        trigger.run(true);
+        while (woken < round * waiterCount) {
+            std::this_thread::yield();
+        }
+    }
+    running = false;
+    trigger.run(true);
+    for (auto& waiter : waiters) {
+        waiter->join();
+    }
+    printResult("EventTrigger wake-up, " + std::to_string(waiterCount) + " CVs", trigger.getStatistics()->wakeUpLatency.snapshot());
+}
+
+struct Ticker
+{
+    void tick() {}
+};
+
+void benchmarkTimerJitter(int rateHz, std::chrono::milliseconds duration)
+{
+    Ticker ticker;
+    essentials::NotifyTimer<Ticker> timer(std::chrono::nanoseconds(1000000000 / rateHz), std::chrono::milliseconds(0), &Ticker::tick, &ticker);
+    timer.enableStatistics();
+    timer.start();
+    std::this_thread::sleep_for(duration);
+    timer.stop();
+    printResult("NotifyTimer lateness, " + std::to_string(rateHz) + " Hz", timer.getStatistics()->lateness.snapshot());
+}
+
+void benchmarkContention(int threadCount, int operations)
+{
+    essentials::EventTrigger trigger;
+    essentials::LatencyHistogram registerCost;
+    essentials::LatencyHistogram isNotifyCalledCost;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&] {
+            std::vector<std::condition_variable> cvs(operations);
+            for (auto& cv : cvs) {
+                auto start = std::chrono::steady_clock::now();
+                trigger.registerCV(&cv);
+                registerCost.record(std::chrono::steady_clock::now() - start);
+            }
+            for (auto& cv : cvs) {
+                auto start = std::chrono::steady_clock::now();
+                trigger.isNotifyCalled(&cv);
+                isNotifyCalledCost.record(std::chrono::steady_clock::now() - start);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    printResult("registerCV, " + std::to_string(threadCount) + " threads", registerCost.snapshot());
+    printResult("isNotifyCalled, " + std::to_string(threadCount) + " threads", isNotifyCalledCost.snapshot());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::chrono::milliseconds timerDuration(1000);
+    if (argc > 1) {
+        timerDuration = std::chrono::milliseconds(static_cast<long>(atof(argv[1]) * 1000));
+    }
+
+    printHeader();
+    for (int waiterCount : {1, 10, 100, 1000}) {
+        benchmarkTriggerWakeUp(waiterCount, waiterCount >= 1000 ? 50 : 500);
+    }
+    for (int rateHz : {100, 1000, 5000}) {
+        benchmarkTimerJitter(rateHz, timerDuration);
+    }
+    for (int threadCount : {1, 4, 16}) {
+        benchmarkContention(threadCount, 10000);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "ITrigger.hpp"
+#include "TimerService.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace essentials
+{
+
+/**
+ * Base of the triggers, which fold several runs into a single notification of the
+ * registered condition variables. Woken consumers take the number of runs that
+ * happened since they took it the last time.
+ */
+class AggregatingTrigger : public ITrigger
+{
+public:
+    /**
+     * @return The number of runs delivered since the last call, which resets it.
+     */
+    uint64_t takeEventCount();
+    /**
+     * @return The number of runs, which did not cause a notification of their own.
+     */
+    uint64_t getCoalescedCount();
+    /**
+     * @return The number of notifications.
+     */
+    uint64_t getDeliveryCount();
+
+protected:
+    AggregatingTrigger();
+    /**
+     * Counts a run, which has not been delivered, yet.
+     * @return The number of pending runs.
+     */
+    uint64_t record(bool notifyAllThreads);
+    /**
+     * Notifies the registered condition variables for all pending runs, if there are any.
+     */
+    void deliver();
+
+    std::mutex _mtx;
+
+private:
+    uint64_t _pendingEvents;   /** < Runs since the last notification. */
+    uint64_t _deliveredEvents; /** < Runs notified, but not taken, yet. */
+    uint64_t _coalescedCount;
+    uint64_t _deliveryCount;
+    bool _notifyAllThreads; /** < As given to the latest run. */
+};
+
+/**
+ * Notifies once the runs stop for the given window, i.e., a burst of runs is
+ * delivered a window after its last run.
+ */
+class DebounceTrigger : public AggregatingTrigger
+{
+public:
+    DebounceTrigger(std::chrono::nanoseconds window, TimerService& service);
+    ~DebounceTrigger() override;
+    void run(bool notifyAllThreads) override;
+
+private:
+    std::chrono::nanoseconds _window;
+    TimerService& _service;
+    TimerEntry _entry;
+};
+
+/**
+ * Notifies at most once per interval. A run after a quiet interval is delivered
+ * right away, later runs are delivered together at the end of the interval.
+ */
+class ThrottleTrigger : public AggregatingTrigger
+{
+public:
+    ThrottleTrigger(std::chrono::nanoseconds interval, TimerService& service);
+    ~ThrottleTrigger() override;
+    void run(bool notifyAllThreads) override;
+
+private:
+    void flush(); /** < Called by the service at the end of the interval. */
+
+    std::chrono::nanoseconds _interval;
+    TimerService& _service;
+    TimerEntry _entry;
+    bool _flushScheduled;
+    IClock::time_point _lastDelivery;
+};
+
+/**
+ * Notifies once per batch of the given number of runs. With a service, an incomplete
+ * batch is delivered at the latest after the given delay after its first run.
+ */
+class CoalescingTrigger : public AggregatingTrigger
+{
+public:
+    explicit CoalescingTrigger(uint64_t batchSize);
+    CoalescingTrigger(uint64_t batchSize, std::chrono::nanoseconds maxDelay, TimerService& service);
+    ~CoalescingTrigger() override;
+    void run(bool notifyAllThreads) override;
+
+private:
+    void flush(); /** < Called by the service after the maximal delay. */
+
+    uint64_t _batchSize;
+    std::chrono::nanoseconds _maxDelay;
+    TimerService* _service;
+    TimerEntry _entry;
+    bool _flushScheduled;
+};
+
+} /* namespace essentials */
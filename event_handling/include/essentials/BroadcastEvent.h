@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Futex.h"
+#include "WaitPolicy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace essentials
+{
+
+/**
+ * An event for a large number of waiters. Instead of registering with the event,
+ * each waiter remembers the generation it has seen last. Firing increments the
+ * generation and makes at most one system call, which wakes all threads blocked
+ * on the shared generation word, no matter how many waiters there are.
+ *
+ * The generation is a 32 bit counter, so a waiter that sleeps through exactly
+ * 2^32 fires cannot tell that the event fired.
+ */
+class BroadcastEvent
+{
+public:
+    BroadcastEvent()
+            : _generation(0)
+            , _waiters(0)
+    {
+    }
+    BroadcastEvent(const BroadcastEvent&) = delete;
+    BroadcastEvent& operator=(const BroadcastEvent&) = delete;
+
+    void run()
+    {
+        _generation.fetch_add(1);
+        if (_waiters.load() > 0) {
+            futexWake(&_generation);
+        }
+    }
+    uint32_t getGeneration() const { return _generation.load(std::memory_order_acquire); }
+    bool hasFiredSince(uint32_t seenGeneration) const { return getGeneration() != seenGeneration; }
+
+    /**
+     * Blocks until the event fired after the given generation was seen.
+     * @return The current generation, which the caller should remember for its next wait.
+     */
+    uint32_t wait(uint32_t seenGeneration)
+    {
+        uint32_t generation;
+        while ((generation = getGeneration()) == seenGeneration) {
+            block(seenGeneration, std::chrono::nanoseconds::max());
+        }
+        return generation;
+    }
+    /**
+     * Blocks until the event fired after the given generation was seen, or the timeout expired.
+     * @return True, if the event fired. The generation is updated to the current one in both cases.
+     */
+    bool waitFor(uint32_t& generation, std::chrono::nanoseconds timeout)
+    {
+        uint32_t seenGeneration = generation;
+        auto deadline = futexDeadline(timeout);
+        while ((generation = getGeneration()) == seenGeneration) {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+            block(seenGeneration, remaining);
+        }
+        return true;
+    }
+
+    /**
+     * Like wait, but spins and yields according to the policy before blocking.
+     */
+    uint32_t wait(uint32_t seenGeneration, AdaptiveWaitPolicy& policy)
+    {
+        policy.wait([this, seenGeneration] { return hasFiredSince(seenGeneration); },
+                [this, seenGeneration] {
+                    wait(seenGeneration);
+                    return true;
+                });
+        return getGeneration();
+    }
+    bool waitFor(uint32_t& generation, std::chrono::nanoseconds timeout, AdaptiveWaitPolicy& policy)
+    {
+        auto deadline = futexDeadline(timeout);
+        uint32_t seenGeneration = generation;
+        bool fired = policy.wait([this, seenGeneration] { return hasFiredSince(seenGeneration); },
+                [this, &generation, deadline] { return waitFor(generation, deadline - std::chrono::steady_clock::now()); });
+        generation = getGeneration();
+        return fired;
+    }
+
+private:
+    void block(uint32_t seenGeneration, std::chrono::nanoseconds timeout)
+    {
+        // see FutexTrigger: announce the waiter before the futex checks the generation
+        _waiters.fetch_add(1);
+        futexWait(&_generation, seenGeneration, timeout);
+        _waiters.fetch_sub(1);
+    }
+
+    std::atomic<uint32_t> _generation; /** < The futex word all waiters block on. */
+    std::atomic<uint32_t> _waiters;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * The time source of the timers. Timers wait for their deadlines through the
+ * clock, so the same timer code runs in real time on the SteadyClock and in
+ * virtual time on a ManualClock.
+ */
+class IClock
+{
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~IClock() = default;
+    virtual time_point now() const = 0;
+    /**
+     * Blocks on the condition variable until the predicate holds or the deadline of
+     * this clock is reached. The lock must be held and guard the state of the predicate.
+     * @return The value of the predicate.
+     */
+    virtual bool waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, time_point deadline, const std::function<bool()>& predicate) = 0;
+};
+
+/**
+ * Real time, as given by std::chrono::steady_clock.
+ */
+class SteadyClock : public IClock
+{
+public:
+    /**
+     * @return The clock used by the timers by default.
+     */
+    static SteadyClock& getInstance();
+
+    time_point now() const override { return std::chrono::steady_clock::now(); }
+    bool waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, time_point deadline, const std::function<bool()>& predicate) override
+    {
+        return cv.wait_until(lock, deadline, predicate);
+    }
+};
+
+/**
+ * Virtual time, which only moves when it is advanced. Advancing the clock wakes the
+ * waiting timers, so tests and simulations run as fast as their callbacks allow.
+ * The clock must outlive the timers using it.
+ */
+class ManualClock : public IClock
+{
+public:
+    explicit ManualClock(time_point start = time_point());
+    ManualClock(const ManualClock&) = delete;
+    ManualClock& operator=(const ManualClock&) = delete;
+
+    time_point now() const override;
+    bool waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, time_point deadline, const std::function<bool()>& predicate) override;
+    /**
+     * Moves the time forward by the given duration and wakes all waiting threads.
+     */
+    void advance(std::chrono::nanoseconds duration);
+    /**
+     * Sets the time, which must not be before the current time, and wakes all waiting threads.
+     */
+    void setTime(time_point time);
+    /**
+     * The number of threads waiting for a deadline of this clock. Tests use it to
+     * advance the time only after the timer threads went back to waiting.
+     */
+    size_t getWaiterCount();
+
+private:
+    struct Waiter
+    {
+        std::condition_variable* cv;
+        std::mutex* mtx;
+    };
+
+    std::atomic<int64_t> _nowNs;
+    std::mutex _waitersMtx; /** < Locked before the mutexes of the waiters, never after. */
+    std::vector<Waiter*> _waiters;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace essentials
+{
+
+enum class ThreadScheduling
+{
+    DEFAULT,    /** < Inherits the scheduling of the creating thread. */
+    FIFO,       /** < SCHED_FIFO, runs until it blocks or a thread of higher priority gets ready. */
+    ROUND_ROBIN /** < SCHED_RR, like FIFO but with time slices among threads of the same priority. */
+};
+
+/**
+ * The configuration of a thread, e.g., of a timer. The defaults leave everything as
+ * for a std::thread. Real-time scheduling usually requires CAP_SYS_NICE or an
+ * RLIMIT_RTPRIO, locking memory a large enough RLIMIT_MEMLOCK.
+ */
+struct ThreadOptions
+{
+    ThreadScheduling scheduling = ThreadScheduling::DEFAULT;
+    int priority = 0;          /** < The real-time priority, between 1 and 99 for FIFO and ROUND_ROBIN. */
+    std::vector<int> cpus;     /** < The CPUs the thread may run on, all if empty. */
+    size_t stackSize = 0;      /** < In bytes, the system default if 0. */
+    bool lockStack = false;    /** < Locks the stack into memory, so the thread never waits for it to be paged in. */
+};
+
+/**
+ * A thread, which is created with the given options. In contrast to applying them
+ * after the start, the function never runs with a partial configuration.
+ */
+class ConfiguredThread
+{
+public:
+    /**
+     * Starts the thread, once it runs with all options applied.
+     * @throws std::system_error, if an option could not be applied, e.g., because of missing permissions.
+     */
+    ConfiguredThread(const ThreadOptions& options, std::function<void()> function);
+    /**
+     * Joins the thread, if that did not happen, yet.
+     */
+    ~ConfiguredThread();
+    ConfiguredThread(const ConfiguredThread&) = delete;
+    ConfiguredThread& operator=(const ConfiguredThread&) = delete;
+
+    void join();
+    pthread_t getNativeHandle() const { return _thread; }
+
+private:
+    static void* start(void* startup);
+
+    pthread_t _thread;
+    bool _joined;
+};
+
+} /* namespace essentials */
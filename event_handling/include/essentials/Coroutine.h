@@ -0,0 +1,258 @@
+#pragma once
+
+/**
+ * Coroutine support for triggers and timers. Instead of blocking a thread on a
+ * condition variable, a coroutine awaits the next run of a trigger or the next tick
+ * of a timer and is resumed by a CoroutineScheduler. A suspended waiter costs its
+ * coroutine frame and is linked into the wait list without allocating.
+ *
+ * Everything in here requires C++20 coroutines and is left out otherwise.
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include "EventTrigger.h"
+#include "Timer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace essentials
+{
+
+/**
+ * Resumes coroutines on the thread calling run or runReady.
+ */
+class CoroutineScheduler
+{
+public:
+    CoroutineScheduler() = default;
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    /**
+     * Queues the coroutine for being resumed. May be called from any thread.
+     */
+    void schedule(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lockGuard(_mtx);
+            _ready.push_back(handle);
+        }
+        _cv.notify_one();
+    }
+
+    /**
+     * Resumes the coroutines queued at the time of the call.
+     * @return The number of resumed coroutines.
+     */
+    size_t runReady()
+    {
+        std::deque<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lockGuard(_mtx);
+            ready.swap(_ready);
+        }
+        for (std::coroutine_handle<> handle : ready) {
+            handle.resume();
+        }
+        return ready.size();
+    }
+
+    /**
+     * Resumes queued coroutines until stop is called.
+     */
+    void run()
+    {
+        std::unique_lock<std::mutex> lck(_mtx);
+        _running = true;
+        while (_running) {
+            _cv.wait(lck, [this] { return !_running || !_ready.empty(); });
+            while (!_ready.empty()) {
+                std::coroutine_handle<> handle = _ready.front();
+                _ready.pop_front();
+                lck.unlock();
+                handle.resume();
+                lck.lock();
+            }
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lockGuard(_mtx);
+            _running = false;
+        }
+        _cv.notify_all();
+    }
+
+    /**
+     * Awaiting the result moves the awaiting coroutine to the thread of this scheduler.
+     */
+    auto resumeOn()
+    {
+        struct Awaiter
+        {
+            CoroutineScheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.schedule(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+private:
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::deque<std::coroutine_handle<>> _ready;
+    bool _running = false;
+};
+
+/**
+ * The return type of coroutines that are started right away and destroy themselves when finished.
+ */
+struct CoroutineTask
+{
+    struct promise_type
+    {
+        CoroutineTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * The coroutines waiting for the same event. The awaiters are part of the
+ * coroutine frames and linked into an intrusive list.
+ */
+class CoroutineWaitList
+{
+public:
+    struct Awaiter
+    {
+        CoroutineWaitList& list;
+        std::coroutine_handle<> handle = nullptr;
+        Awaiter* next = nullptr;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> awaiting)
+        {
+            handle = awaiting;
+            list.push(this);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    explicit CoroutineWaitList(CoroutineScheduler& scheduler)
+            : _scheduler(&scheduler)
+    {
+    }
+
+    Awaiter wait() { return Awaiter{*this}; }
+
+    /**
+     * Hands all waiting coroutines to the scheduler.
+     */
+    void resumeAll()
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        if (!_scheduler) {
+            return;
+        }
+        while (_head) {
+            Awaiter* awaiter = _head;
+            _head = awaiter->next;
+            _scheduler->schedule(awaiter->handle);
+        }
+    }
+
+    /**
+     * Stops handing coroutines to the scheduler, e.g., because it is destroyed.
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        _scheduler = nullptr;
+    }
+
+private:
+    void push(Awaiter* awaiter)
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        awaiter->next = _head;
+        _head = awaiter;
+    }
+
+    std::mutex _mtx;
+    CoroutineScheduler* _scheduler;
+    Awaiter* _head = nullptr;
+};
+
+/**
+ * Allows to co_await the next run of an EventTrigger. Runs of the trigger
+ * while no coroutine waits are not remembered. The trigger must outlive this object.
+ */
+class AsyncTrigger
+{
+public:
+    AsyncTrigger(EventTrigger& trigger, CoroutineScheduler& scheduler)
+            : _trigger(trigger)
+            , _waiters(std::make_shared<CoroutineWaitList>(scheduler))
+    {
+        // a run, which started before unregistering, may still call the callback, so it shares the wait list
+        std::shared_ptr<CoroutineWaitList> waiters = _waiters;
+        _callbackId = trigger.registerCallback([waiters] { waiters->resumeAll(); });
+    }
+    ~AsyncTrigger()
+    {
+        _trigger.unregisterCallback(_callbackId);
+        _waiters->close();
+    }
+    AsyncTrigger(const AsyncTrigger&) = delete;
+    AsyncTrigger& operator=(const AsyncTrigger&) = delete;
+
+    CoroutineWaitList::Awaiter operator co_await() { return _waiters->wait(); }
+
+private:
+    EventTrigger& _trigger;
+    std::shared_ptr<CoroutineWaitList> _waiters;
+    int _callbackId;
+};
+
+/**
+ * A Timer whose ticks can be awaited with co_await timer.nextTick().
+ */
+class AsyncTimer
+{
+public:
+    AsyncTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, CoroutineScheduler& scheduler)
+            : _waiters(scheduler)
+            , _timer(interval, delayedStart, [this] { _waiters.resumeAll(); })
+    {
+    }
+    AsyncTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, CoroutineScheduler& scheduler, TimerService& service)
+            : _waiters(scheduler)
+            , _timer(interval, delayedStart, [this] { _waiters.resumeAll(); }, service)
+    {
+    }
+
+    CoroutineWaitList::Awaiter nextTick() { return _waiters.wait(); }
+    Timer& getTimer() { return _timer; }
+    bool start() { return _timer.start(); }
+    bool stop() { return _timer.stop(); }
+
+private:
+    CoroutineWaitList _waiters;
+    Timer _timer; /** < Declared last, so it is stopped before the wait list is destroyed. */
+};
+
+} /* namespace essentials */
+
+#endif
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "Futex.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace essentials
+{
+
+/**
+ * A bounded ring buffer for a single producer and a single consumer. The slots are
+ * allocated once, pushing and popping neither allocate nor lock.
+ */
+template <class T>
+class SpscRing
+{
+public:
+    /**
+     * @param capacity Is rounded up to the next power of two.
+     */
+    explicit SpscRing(size_t capacity)
+            : _mask(roundUp(capacity) - 1)
+            , _slots(new Slot[_mask + 1])
+            , _head(0)
+            , _tail(0)
+            , _cachedHead(0)
+            , _cachedTail(0)
+    {
+    }
+    ~SpscRing()
+    {
+        T item;
+        while (tryPop(item)) {
+        }
+    }
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    template <class U>
+    bool tryPush(U&& item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead > _mask) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead > _mask) {
+                return false;
+            }
+        }
+        new (&_slots[tail & _mask]) T(std::forward<U>(item));
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pushes as many of the count items as fit and publishes them at once.
+     * @return The number of pushed items.
+     */
+    template <class InputIterator>
+    size_t tryPushBatch(InputIterator first, size_t count)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t free = _mask + 1 - (tail - _cachedHead);
+        if (free < count) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            free = _mask + 1 - (tail - _cachedHead);
+        }
+        size_t pushed = count < free ? count : free;
+        for (size_t i = 0; i < pushed; ++i, ++first) {
+            new (&_slots[(tail + i) & _mask]) T(*first);
+        }
+        _tail.store(tail + pushed, std::memory_order_release);
+        return pushed;
+    }
+
+    bool tryPop(T& item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) {
+                return false;
+            }
+        }
+        T* slot = reinterpret_cast<T*>(&_slots[head & _mask]);
+        item = std::move(*slot);
+        slot->~T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pops up to maxCount items and releases their slots at once.
+     * @return The number of popped items.
+     */
+    template <class OutputIterator>
+    size_t tryPopBatch(OutputIterator out, size_t maxCount)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        _cachedTail = _tail.load(std::memory_order_acquire);
+        size_t available = _cachedTail - head;
+        size_t popped = maxCount < available ? maxCount : available;
+        for (size_t i = 0; i < popped; ++i, ++out) {
+            T* slot = reinterpret_cast<T*>(&_slots[(head + i) & _mask]);
+            *out = std::move(*slot);
+            slot->~T();
+        }
+        _head.store(head + popped, std::memory_order_release);
+        return popped;
+    }
+
+    size_t getCapacity() const { return _mask + 1; }
+    bool empty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+
+private:
+    using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    // producer and consumer indices on separate cache lines, so they do not invalidate each other
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+    alignas(64) size_t _cachedHead; /** < The producer's latest view of the head. */
+    alignas(64) size_t _cachedTail; /** < The consumer's latest view of the tail. */
+};
+
+/**
+ * A bounded ring buffer for many producers and a single consumer. Producers claim
+ * slots with a compare-and-swap, each slot carries a sequence number telling whether
+ * it is free or filled, so neither side ever locks or allocates.
+ */
+template <class T>
+class MpscRing
+{
+public:
+    /**
+     * @param capacity Is rounded up to the next power of two.
+     */
+    explicit MpscRing(size_t capacity)
+            : _mask(roundUp(capacity) - 1)
+            , _slots(new Slot[_mask + 1])
+            , _head(0)
+            , _tail(0)
+    {
+        for (size_t i = 0; i <= _mask; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MpscRing()
+    {
+        T item;
+        while (tryPop(item)) {
+        }
+    }
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    template <class U>
+    bool tryPush(U&& item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[tail & _mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(tail);
+            if (difference == 0) {
+                if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    new (&slot.storage) T(std::forward<U>(item));
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // the slot still holds the item of the previous round
+                return false;
+            } else {
+                tail = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Pushes as many of the count items as fit.
+     * @return The number of pushed items.
+     */
+    template <class InputIterator>
+    size_t tryPushBatch(InputIterator first, size_t count)
+    {
+        size_t pushed = 0;
+        for (; pushed < count && tryPush(*first); ++pushed, ++first) {
+        }
+        return pushed;
+    }
+
+    bool tryPop(T& item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        Slot& slot = _slots[head & _mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        T* stored = reinterpret_cast<T*>(&slot.storage);
+        item = std::move(*stored);
+        stored->~T();
+        // frees the slot for the producers of the next round
+        slot.sequence.store(head + _mask + 1, std::memory_order_release);
+        _head.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Pops up to maxCount items.
+     * @return The number of popped items.
+     */
+    template <class OutputIterator>
+    size_t tryPopBatch(OutputIterator out, size_t maxCount)
+    {
+        size_t popped = 0;
+        T item;
+        for (; popped < maxCount && tryPop(item); ++popped, ++out) {
+            *out = std::move(item);
+        }
+        return popped;
+    }
+
+    size_t getCapacity() const { return _mask + 1; }
+    bool empty() const
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        return _slots[head & _mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+/**
+ * Hands typed events from producers to a consumer through a preallocated ring buffer.
+ * The consumer can block until events arrive, like waiting on a trigger. Producers
+ * only make the system call for waking it, if it actually waits.
+ * @tparam T The payload, which needs to be default constructible and move assignable.
+ * @tparam Ring SpscRing for a single producer, MpscRing for many.
+ */
+template <class T, template <class> class Ring = SpscRing>
+class EventChannel
+{
+public:
+    explicit EventChannel(size_t capacity)
+            : _ring(capacity)
+            , _signal(0)
+            , _waiters(0)
+    {
+    }
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    /**
+     * @return False, if the channel is full.
+     */
+    template <class U>
+    bool tryPush(U&& item)
+    {
+        if (!_ring.tryPush(std::forward<U>(item))) {
+            return false;
+        }
+        wakeConsumer();
+        return true;
+    }
+    /**
+     * @return The number of pushed items, which is less than count, if the channel is full.
+     */
+    template <class InputIterator>
+    size_t tryPushBatch(InputIterator first, size_t count)
+    {
+        size_t pushed = _ring.tryPushBatch(first, count);
+        if (pushed > 0) {
+            wakeConsumer();
+        }
+        return pushed;
+    }
+
+    bool tryPop(T& item) { return _ring.tryPop(item); }
+    template <class OutputIterator>
+    size_t tryPopBatch(OutputIterator out, size_t maxCount)
+    {
+        return _ring.tryPopBatch(out, maxCount);
+    }
+    /**
+     * Blocks until an event is available, at most for the given timeout.
+     * @return False, if the timeout expired.
+     */
+    bool pop(T& item, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+    {
+        return waitFor([&] { return _ring.tryPop(item); }, timeout);
+    }
+    /**
+     * Blocks until at least one event is available, at most for the given timeout,
+     * and pops up to maxCount events.
+     * @return The number of popped events, 0 if the timeout expired.
+     */
+    template <class OutputIterator>
+    size_t popBatch(OutputIterator out, size_t maxCount, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+    {
+        size_t popped = 0;
+        waitFor([&] { return (popped = _ring.tryPopBatch(out, maxCount)) > 0; }, timeout);
+        return popped;
+    }
+
+    size_t getCapacity() const { return _ring.getCapacity(); }
+    bool empty() const { return _ring.empty(); }
+
+private:
+    void wakeConsumer()
+    {
+        _signal.fetch_add(1, std::memory_order_release);
+        // pairs with the fence of the consumer, so either it sees the event or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiters.load(std::memory_order_relaxed) > 0) {
+            futexWake(&_signal);
+        }
+    }
+
+    template <class TryConsume>
+    bool waitFor(TryConsume tryConsume, std::chrono::nanoseconds timeout)
+    {
+        if (tryConsume()) {
+            return true;
+        }
+        bool infinite = timeout == std::chrono::nanoseconds::max();
+        auto deadline = infinite ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            uint32_t signal = _signal.load(std::memory_order_acquire);
+            _waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tryConsume()) {
+                _waiters.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            auto remaining = infinite ? std::chrono::nanoseconds::max() : std::chrono::nanoseconds(deadline - std::chrono::steady_clock::now());
+            bool inTime = futexWait(&_signal, signal, remaining);
+            _waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (tryConsume()) {
+                return true;
+            }
+            if (!inTime) {
+                return false;
+            }
+        }
+    }
+
+    Ring<T> _ring;
+    alignas(64) std::atomic<uint32_t> _signal; /** < The futex word, counts the pushes. */
+    std::atomic<uint32_t> _waiters;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "EventTrigger.h"
+#include "InplaceFunction.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace essentials
+{
+
+/**
+ * A reactor, which serves file descriptors, timers and triggers from a single
+ * thread blocked in epoll. Timers are kernel timers (timerfd on the monotonic
+ * clock), triggers are eventfds written by the trigger's callback. All callbacks
+ * are called by the thread of the loop and should therefore return quickly.
+ *
+ * All methods may be called from any thread, including from the callbacks.
+ * If a watch is removed by another thread, its callback might still be running
+ * when the remove method returns.
+ */
+class EventLoop
+{
+public:
+    using FdCallback = InplaceFunction<void(uint32_t events)>;
+    using Callback = InplaceFunction<void()>;
+
+    /**
+     * Creates the epoll instance and starts the thread of the loop.
+     * @throws std::system_error, if the kernel objects could not be created.
+     */
+    EventLoop();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * Calls the callback with the ready epoll events, whenever the file descriptor
+     * is ready for one of the given events, e.g., EPOLLIN. The descriptor stays owned by the caller.
+     * @return False, if the descriptor could not be added, e.g., because it is already watched.
+     */
+    bool watch(int fd, uint32_t events, FdCallback callback);
+    /**
+     * Stops watching the descriptor without closing it.
+     */
+    bool unwatch(int fd);
+    /**
+     * Creates a timer, which calls the callback after the given delay and, if the interval
+     * is not zero, every interval afterwards. Expirations that happen while the loop is
+     * busy are folded into a single call.
+     * @return The id of the timer, or -1 on failure.
+     */
+    int addTimer(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, Callback callback);
+    /**
+     * Restarts the timer with the given delay and interval.
+     */
+    bool rearmTimer(int timerId, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval);
+    bool removeTimer(int timerId);
+    /**
+     * Calls the callback on the thread of the loop, whenever the trigger runs. Several runs
+     * before the loop gets to the trigger are folded into a single call.
+     * @return The id of the trigger in this loop, or -1 on failure.
+     */
+    int addTrigger(EventTrigger& trigger, Callback callback);
+    /**
+     * Stops calling the callback of the trigger and unregisters it from the trigger.
+     * The trigger must outlive the loop or this call.
+     */
+    bool removeTrigger(int triggerId);
+
+private:
+    enum class WatchType
+    {
+        FD,
+        TIMER,
+        TRIGGER,
+        WAKE_UP
+    };
+    /**
+     * The eventfd written by the callback registered at a trigger. A run of the trigger,
+     * which started before the callback was unregistered, may still call it, so the
+     * callback checks whether the descriptor is still valid.
+     */
+    struct TriggerLink
+    {
+        std::mutex mtx;
+        int fd;
+    };
+    /**
+     * Closes the timerfds and eventfds created by the loop, when the last reference is
+     * gone, so that the loop thread never uses a descriptor that was closed and reused.
+     */
+    struct Watch
+    {
+        ~Watch();
+        int fd;
+        uint32_t generation; /** < Tells stale events of a reused descriptor apart. */
+        WatchType type;
+        FdCallback fdCallback;
+        Callback callback;
+        std::shared_ptr<TriggerLink> link;
+        EventTrigger* trigger;
+        int callbackId; /** < The id of the callback registered at the trigger. */
+    };
+
+    void run(); /** < The method executed by the thread of the loop */
+    bool add(std::shared_ptr<Watch> watch, uint32_t events);
+    std::shared_ptr<Watch> remove(int fd, WatchType type);
+    void dispatch(const Watch& watch, uint32_t events);
+    static bool setTime(int timerFd, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval);
+
+    int _epollFd;
+    int _wakeUpFd; /** < Wakes up the loop for shutting down. */
+    std::mutex _mtx;
+    std::unordered_map<int, std::shared_ptr<Watch>> _watches;
+    uint32_t _nextGeneration;
+    bool _running;
+    std::thread _loopThread;
+};
+
+} /* namespace essentials */
@@ -1,12 +1,72 @@
 #pragma once
 
+#include "BroadcastEvent.h"
+#include "IExecutor.h"
 #include "ITrigger.hpp"
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace essentials
 {
 class EventTrigger : public ITrigger
 {
 public:
+    ~EventTrigger() override;
     void run(bool notifyAll) override;
+    /**
+     * Registers a callback, which is called on each run after the registered
+     * condition variables have been notified. The callbacks are called without
+     * holding a lock of the trigger, so they may register further callbacks.
+     * @return The id for unregistering the callback.
+     */
+    int registerCallback(std::function<void()> callback);
+    /**
+     * Removes the callback. A run, which started before, may still call it.
+     * @return False, if there is no such callback.
+     */
+    bool unregisterCallback(int callbackId);
+    /**
+     * Sets the executor the callbacks are handed to. Without an executor,
+     * the callbacks are called by the thread calling run.
+     */
+    void setExecutor(IExecutor* executor);
+    /**
+     * Fires on each run. Waiting on its generation scales to any number of waiters,
+     * without registering a condition variable for each of them.
+     */
+    BroadcastEvent& getBroadcastEvent() { return _broadcastEvent; }
+    /**
+     * Starts recording the wake-up latency, i.e., the time from the latest run
+     * to the calls of recordWakeUp. The statistics live as long as the trigger.
+     */
+    void enableStatistics();
+    /**
+     * @return The recorded statistics, or nullptr if they are not enabled.
+     */
+    TriggerStatistics* getStatistics() const;
+    /**
+     * To be called by a woken thread, if statistics are enabled.
+     */
+    void recordWakeUp();
+
+private:
+    struct RegisteredCallback
+    {
+        int id;
+        std::function<void()> callback;
+    };
+
+    std::atomic<TriggerStatistics*> _statistics{nullptr};
+    std::atomic<int64_t> _lastRunNs{0}; /** < The steady clock time of the latest run, if statistics are enabled. */
+    BroadcastEvent _broadcastEvent;
+    std::mutex _callbackMtx;
+    std::shared_ptr<const std::vector<RegisteredCallback>> _callbacks; /** < Replaced on (un)registering, run only copies the pointer. */
+    int _nextCallbackId = 0;
+    IExecutor* _executor = nullptr;
 };
 } // namespace essentials
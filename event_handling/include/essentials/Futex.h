@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace essentials
+{
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex words need to be plain 32 bit integers!");
+
+/**
+ * Blocks the calling thread as long as the word has the expected value, at most for the given timeout.
+ * Like every futex wait, this may return spuriously, so callers need to check their condition again.
+ * @return False, if the timeout expired.
+ */
+inline bool futexWait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+{
+    struct timespec relative;
+    struct timespec* relativePtr = nullptr;
+    if (timeout != std::chrono::nanoseconds::max()) {
+        if (timeout.count() <= 0) {
+            return false;
+        }
+        relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+        relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        relativePtr = &relative;
+    }
+    long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, relativePtr, nullptr, 0);
+    return !(result == -1 && errno == ETIMEDOUT);
+}
+
+/**
+ * The time of the steady clock the timeout expires at. It is saturated at the end of the
+ * clock, so that timeouts like nanoseconds::max() do not overflow into the past.
+ */
+inline std::chrono::steady_clock::time_point futexDeadline(std::chrono::nanoseconds timeout)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (timeout > std::chrono::steady_clock::time_point::max() - now) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return now + timeout;
+}
+
+/**
+ * Wakes up to count threads blocked on the word.
+ */
+inline void futexWake(std::atomic<uint32_t>* word, int count = INT_MAX)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+} /* namespace essentials */
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Futex.h"
+#include "WaitPolicy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace essentials
+{
+
+/**
+ * A trigger without mutexes and condition variables. Firing and checking are
+ * single atomic operations and waiting threads block on the trigger state
+ * itself via a futex, so the system call for waking is only made if
+ * somebody actually waits.
+ *
+ * In contrast to ITrigger, there is one notify-called flag for all waiters.
+ */
+class FutexTrigger
+{
+public:
+    FutexTrigger()
+            : _state(0)
+            , _waiters(0)
+    {
+    }
+    FutexTrigger(const FutexTrigger&) = delete;
+    FutexTrigger& operator=(const FutexTrigger&) = delete;
+
+    /**
+     * Sets the notify-called flag and wakes one or all waiting threads.
+     */
+    void run(bool notifyAllThreads)
+    {
+        _state.store(1);
+        if (_waiters.load() > 0) {
+            futexWake(&_state, notifyAllThreads ? INT_MAX : 1);
+        }
+    }
+    bool isNotifyCalled() const { return _state.load(std::memory_order_acquire) == 1; }
+    void setNotifyCalled(bool called) { _state.store(called ? 1 : 0, std::memory_order_release); }
+    /**
+     * Resets the notify-called flag.
+     * @return True, if it was set.
+     */
+    bool tryConsume() { return _state.exchange(0, std::memory_order_acq_rel) == 1; }
+
+    /**
+     * Blocks until the notify-called flag is set. The flag is not reset.
+     */
+    void wait()
+    {
+        while (!isNotifyCalled()) {
+            block(std::chrono::nanoseconds::max());
+        }
+    }
+    /**
+     * Blocks until the notify-called flag is set or the timeout expired.
+     * @return True, if the flag is set.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout)
+    {
+        auto deadline = futexDeadline(timeout);
+        while (!isNotifyCalled()) {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+            block(remaining);
+        }
+        return true;
+    }
+
+    /**
+     * Like wait, but spins and yields according to the policy before blocking.
+     */
+    void wait(AdaptiveWaitPolicy& policy)
+    {
+        policy.wait([this] { return isNotifyCalled(); },
+                [this] {
+                    wait();
+                    return true;
+                });
+    }
+    bool waitFor(std::chrono::nanoseconds timeout, AdaptiveWaitPolicy& policy)
+    {
+        auto deadline = futexDeadline(timeout);
+        return policy.wait([this] { return isNotifyCalled(); }, [this, deadline] { return waitFor(deadline - std::chrono::steady_clock::now()); });
+    }
+
+private:
+    void block(std::chrono::nanoseconds timeout)
+    {
+        // the waiter count is raised before the futex checks the state, so run cannot miss this waiter
+        _waiters.fetch_add(1);
+        futexWait(&_state, 0, timeout);
+        _waiters.fetch_sub(1);
+    }
+
+    std::atomic<uint32_t> _state; /** < The futex word, 1 if notify was called, 0 otherwise. */
+    std::atomic<uint32_t> _waiters;
+};
+
+} /* namespace essentials */
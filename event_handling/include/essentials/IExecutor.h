@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+
+namespace essentials
+{
+
+/**
+ * Executes tasks handed over by timers and triggers, so that their
+ * timekeeping threads do not have to wait for the tasks to finish.
+ */
+class IExecutor
+{
+public:
+    virtual ~IExecutor() = default;
+    virtual void execute(std::function<void()> task) = 0;
+};
+
+/**
+ * Executes each task right away on the calling thread.
+ */
+class InlineExecutor : public IExecutor
+{
+public:
+    void execute(std::function<void()> task) override { task(); }
+};
+
+} /* namespace essentials */
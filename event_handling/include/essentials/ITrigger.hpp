@@ -1,5 +1,8 @@
 #pragma once
 
+#include "BroadcastEvent.h"
+#include "WaitPolicy.h"
+
 #include <condition_variable>
 #include <iostream>
 #include <unordered_map>
@@ -32,6 +35,26 @@ public:
         }
     }
 
+    /**
+     * Waits until notify was called for the registered condition variable, spinning and yielding
+     * according to the policy before it blocks with the given lock released. The flag is not reset.
+     */
+    void waitForNotify(std::condition_variable* cv, std::unique_lock<std::mutex>& lock, AdaptiveWaitPolicy& policy)
+    {
+        policy.wait([this, cv] { return isNotifyCalled(cv); },
+                [this, cv, &lock] {
+                    // the notifier does not hold the given lock, so the waiter blocks on the notify event, whose
+                    // generation is raised after the flag is set, and a notification after reading it cannot be missed
+                    uint32_t generation = _notifyEvent.getGeneration();
+                    while (!isNotifyCalled(cv)) {
+                        lock.unlock();
+                        generation = _notifyEvent.wait(generation);
+                        lock.lock();
+                    }
+                    return true;
+                });
+    }
+
 protected:
     bool isAnyCVRegistered()
     {
@@ -48,6 +71,7 @@ protected:
             } else {
                 cv->notify_one();
             }
+            _notifyEvent.run();
         }
     }
     void notifyEveryCV(bool notifyAllThreads)
@@ -61,11 +85,13 @@ protected:
                 pair.first->notify_one();
             }
         }
+        _notifyEvent.run();
     }
 
 private:
     std::mutex _cvVecMtx;
     std::unordered_map<std::condition_variable*, bool> _registeredCVs;
+    BroadcastEvent _notifyEvent; /** < Fires after the flags were set, for the threads parked in waitForNotify. */
 };
 
 } /* namespace essentials */
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace essentials
+{
+
+template <class Signature, size_t Capacity = 48>
+class InplaceFunction;
+
+/**
+ * A move-only replacement for std::function, which stores the callable in a buffer
+ * of fixed capacity inside of the object. It never allocates, callables that do not
+ * fit into the buffer are rejected at compile time.
+ * @tparam Capacity The size of the buffer in bytes.
+ */
+template <class R, class... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() noexcept
+            : _ops(nullptr)
+    {
+    }
+    InplaceFunction(std::nullptr_t) noexcept
+            : _ops(nullptr)
+    {
+    }
+    template <class Callable, class = typename std::enable_if<!std::is_same<typename std::decay<Callable>::type, InplaceFunction>::value>::type>
+    InplaceFunction(Callable&& callable)
+            : _ops(&OpsFor<typename std::decay<Callable>::type>::get())
+    {
+        using Stored = typename std::decay<Callable>::type;
+        static_assert(sizeof(Stored) <= Capacity, "The callable does not fit into the InplaceFunction, increase its capacity!");
+        static_assert(alignof(Stored) <= alignof(Storage), "The callable is over-aligned for the InplaceFunction!");
+        new (&_storage) Stored(std::forward<Callable>(callable));
+    }
+    InplaceFunction(InplaceFunction&& other) noexcept
+            : _ops(other._ops)
+    {
+        if (_ops) {
+            _ops->move(&other._storage, &_storage);
+            other._ops = nullptr;
+        }
+    }
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            _ops = other._ops;
+            if (_ops) {
+                _ops->move(&other._storage, &_storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+    ~InplaceFunction() { reset(); }
+
+    R operator()(Args... args) const { return _ops->invoke(&_storage, std::forward<Args>(args)...); }
+    explicit operator bool() const noexcept { return _ops != nullptr; }
+
+private:
+    using Storage = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+    struct Ops
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* from, void* to); /** < Moves the callable and destroys the moved-from one. */
+        void (*destroy)(void* storage);
+    };
+
+    template <class Stored>
+    struct OpsFor
+    {
+        static R invoke(void* storage, Args&&... args) { return (*static_cast<Stored*>(storage))(std::forward<Args>(args)...); }
+        static void move(void* from, void* to)
+        {
+            new (to) Stored(std::move(*static_cast<Stored*>(from)));
+            static_cast<Stored*>(from)->~Stored();
+        }
+        static void destroy(void* storage) { static_cast<Stored*>(storage)->~Stored(); }
+        static const Ops& get()
+        {
+            static const Ops ops{&invoke, &move, &destroy};
+            return ops;
+        }
+    };
+
+    void reset()
+    {
+        if (_ops) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+    mutable Storage _storage;
+    const Ops* _ops;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * The counts of a LatencyHistogram at the time of the snapshot.
+ */
+struct HistogramSnapshot
+{
+    std::vector<uint64_t> counts; /** < The count per bucket, see LatencyHistogram::getBucketLowerBound. */
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    /**
+     * @param percentile Between 0 and 100.
+     * @return The upper bound of the bucket holding the given percentile, in nanoseconds.
+     */
+    uint64_t getPercentile(double percentile) const;
+    double getMean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / count; }
+};
+
+/**
+ * A lock-free histogram of durations in nanoseconds with log-linear buckets:
+ * each power of two is split into SUB_BUCKETS linear buckets, so the relative
+ * error of each recorded value is below 1 / SUB_BUCKETS. Recording is a few
+ * relaxed atomic increments and does not allocate.
+ */
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::chrono::nanoseconds duration)
+    {
+        uint64_t value = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+        _counts[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+    /**
+     * Copies the current counts. Values recorded concurrently may or may not be included.
+     * @param reset If true, the copied counts are removed from the histogram.
+     */
+    HistogramSnapshot snapshot(bool reset = false);
+    void reset() { snapshot(true); }
+
+    static int getBucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKETS) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int subBucket = static_cast<int>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+    }
+    static uint64_t getBucketLowerBound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> _counts;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _max;
+};
+
+/**
+ * The histograms recorded by a timer with enabled statistics.
+ */
+struct TimerStatistics
+{
+    LatencyHistogram lateness;         /** < The time between the deadline of a tick and the start of its callback. */
+    LatencyHistogram callbackDuration; /** < The time a callback took to return. */
+};
+
+/**
+ * The histograms recorded by a trigger with enabled statistics.
+ */
+struct TriggerStatistics
+{
+    LatencyHistogram wakeUpLatency; /** < The time between a run of the trigger and a waiter reporting its wake-up. */
+};
+
+} /* namespace essentials */
@@ -1,12 +1,9 @@
 #pragma once
 
 #include "ITrigger.hpp"
+#include "Timer.h"
 
 #include <chrono>
-#include <condition_variable>
-#include <iostream>
-#include <thread>
-#include <vector>
 
 namespace essentials
 {
@@ -16,157 +13,142 @@ using t_notificationcallback = void (NotificationClass::*)();
 
 /**
  * The NotifyTimer allows to have a callback-member function be called in a fixed
- * interval. The calling is delayed after each start by the given delay.
+ * interval, or to notify the registered condition variables in a fixed interval.
+ * It is a trigger on top of the Timer, which does the actual scheduling and is
+ * compiled into the library. See Timer for the semantics of the methods.
  * @tparam NotificationClass
  */
 template <class NotificationClass>
 class NotifyTimer : public ITrigger
 {
 public:
-    NotifyTimer(std::chrono::milliseconds msInterval, std::chrono::milliseconds msDelayedStart, t_notificationcallback<NotificationClass> callback,
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, t_notificationcallback<NotificationClass> callback,
             NotificationClass* obj);
-    NotifyTimer(std::chrono::milliseconds msInterval, std::chrono::milliseconds msDelayedStart, bool notifyAllThreads);
-    ~NotifyTimer() override;
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads);
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, t_notificationcallback<NotificationClass> callback,
+            NotificationClass* obj, TimerService& service);
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads, TimerService& service);
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, t_notificationcallback<NotificationClass> callback,
+            NotificationClass* obj, IClock& clock);
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads, IClock& clock);
     /**
-     * Sets the timer to run.
-     * @return True, if the timer will run after this call. False, otherwise.
+     * @throws std::system_error, if the thread options could not be applied, see Timer.
      */
-    bool start();
-    /**
-     * Sets the timer to stop.
-     * @return True, if the timer will anyways run after this call. False, otherwise.
-     */
-    bool stop();
-    /**
-     * Allows to get the running state of the notify timer.
-     * @return True, if the timer is set to run. False, otherwise.
-     */
-    bool isStarted();
-    std::chrono::milliseconds getDelayedStart() const;
-    std::chrono::milliseconds getInterval() const;
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, t_notificationcallback<NotificationClass> callback,
+            NotificationClass* obj, const ThreadOptions& options, IClock& clock = SteadyClock::getInstance());
+    NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads, const ThreadOptions& options,
+            IClock& clock = SteadyClock::getInstance());
+    ~NotifyTimer() override = default;
+    bool start() { return _timer.start(); }
+    bool stop() { return _timer.stop(); }
+    bool isStarted() { return _timer.isStarted(); }
+    template <class Duration = std::chrono::milliseconds>
+    Duration getDelayedStart() const
+    {
+        return _timer.getDelayedStart<Duration>();
+    }
+    template <class Duration = std::chrono::milliseconds>
+    Duration getInterval() const
+    {
+        return _timer.getInterval<Duration>();
+    }
+    void setSpinThreshold(std::chrono::nanoseconds threshold) { _timer.setSpinThreshold(threshold); }
+    std::chrono::nanoseconds getSpinThreshold() { return _timer.getSpinThreshold(); }
+    void setSchedulingMode(SchedulingMode mode) { _timer.setSchedulingMode(mode); }
+    SchedulingMode getSchedulingMode() { return _timer.getSchedulingMode(); }
+    void setOverrunPolicy(OverrunPolicy policy) { _timer.setOverrunPolicy(policy); }
+    OverrunPolicy getOverrunPolicy() { return _timer.getOverrunPolicy(); }
+    uint64_t getMissedTicks() const { return _timer.getMissedTicks(); }
+    void setExecutor(IExecutor* executor) { _timer.setExecutor(executor); }
+    void enableStatistics() { _timer.enableStatistics(); }
+    TimerStatistics* getStatistics() const { return _timer.getStatistics(); }
 
 private:
-    void run(bool notifyAllThreads) override; /** < The method executed by the notify timer thread */
-    std::mutex _cv_mtx;
-    std::condition_variable _cv;
+    void run(bool notifyAllThreads) override; /** < Called by the timer once per tick */
     t_notificationcallback<NotificationClass> _callback;
     NotificationClass* _obj;
-    bool _running;                             /** < Is always true except when the notify timer is shutting down. */
-    bool _started;                             /** < True, if the NotifyTimer is active. False, otherwise. */
-    std::chrono::milliseconds _msInterval;     /** < The milliseconds between two calls to the callback. */
-    std::chrono::milliseconds _msDelayedStart; /** < The milliseconds between (re)starting the NotifyTimer and the callback call. */
-    std::unique_ptr<std::thread> _runThread;
+    Timer _timer; /** < Declared last, so it is stopped before the other members are destroyed. */
 };
 
 template <class NotificationClass>
-NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::milliseconds msInterval, std::chrono::milliseconds msDelayedStart,
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart,
         t_notificationcallback<NotificationClass> callback, NotificationClass* obj)
-        : _msInterval(msInterval)
-        , _msDelayedStart(msDelayedStart)
-        , _running(true)
-        , _started(false)
-        , _callback(callback)
+        : _callback(callback)
         , _obj(obj)
+        , _timer(interval, delayedStart, [this] { run(false); })
 {
-    /**
-     * We initialise the thread in the body of the constructor
-     * because this guarantees to have all control variables
-     * for this thread initialised properly before it starts.
-     */
-    _runThread = std::make_unique<std::thread>(&NotifyTimer::run, this, false);
 }
 
 template <class NotificationClass>
-NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::milliseconds msInterval, std::chrono::milliseconds msDelayedStart, bool notifyAllThreads)
-        : _msInterval(msInterval)
-        , _msDelayedStart(msDelayedStart)
-        , _running(true)
-        , _started(false)
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads)
+        : _callback(nullptr)
         , _obj(nullptr)
+        , _timer(interval, delayedStart, [this, notifyAllThreads] { run(notifyAllThreads); })
 {
-    _runThread = std::make_unique<std::thread>(&NotifyTimer::run, this, notifyAllThreads);
 }
 
 template <class NotificationClass>
-void NotifyTimer<NotificationClass>::run(bool notifyAllThreads)
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart,
+        t_notificationcallback<NotificationClass> callback, NotificationClass* obj, TimerService& service)
+        : _callback(callback)
+        , _obj(obj)
+        , _timer(interval, delayedStart, [this] { run(false); }, service)
 {
-    while (_running) {
-        {
-            std::unique_lock<std::mutex> lck(_cv_mtx);
-            _cv.wait(lck, [&] { return !_running || _started; });
-        }
-
-        if (!_running) // for destroying the timer
-            return;
-
-        if (_msDelayedStart.count() > 0) {
-            std::this_thread::sleep_for(_msDelayedStart);
-        }
-
-        while (isStarted()) {
-            std::chrono::system_clock::time_point start = std::chrono::high_resolution_clock::now();
-            if (_obj != nullptr) {
-                (_obj->*_callback)();
-            } else {
-                notifyEveryCV(notifyAllThreads);
-            }
-            auto dura = std::chrono::high_resolution_clock::now() - start;
-            std::this_thread::sleep_for(_msInterval - dura);
-        }
-    }
 }
 
 template <class NotificationClass>
-NotifyTimer<NotificationClass>::~NotifyTimer()
+NotifyTimer<NotificationClass>::NotifyTimer(
+        std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads, TimerService& service)
+        : _callback(nullptr)
+        , _obj(nullptr)
+        , _timer(interval, delayedStart, [this, notifyAllThreads] { run(notifyAllThreads); }, service)
 {
-    {
-        std::lock_guard<std::mutex> lockGuard(_cv_mtx);
-        _started = false;
-        _running = false;
-    }
-    _cv.notify_all();
-    _runThread->join();
 }
 
 template <class NotificationClass>
-bool NotifyTimer<NotificationClass>::start()
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart,
+        t_notificationcallback<NotificationClass> callback, NotificationClass* obj, IClock& clock)
+        : _callback(callback)
+        , _obj(obj)
+        , _timer(interval, delayedStart, [this] { run(false); }, clock)
 {
-    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
-    if (_running && !_started) {
-        _started = true;
-    }
-    _cv.notify_all();
-    return _running && _started;
 }
 
 template <class NotificationClass>
-bool NotifyTimer<NotificationClass>::stop()
+NotifyTimer<NotificationClass>::NotifyTimer(
+        std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads, IClock& clock)
+        : _callback(nullptr)
+        , _obj(nullptr)
+        , _timer(interval, delayedStart, [this, notifyAllThreads] { run(notifyAllThreads); }, clock)
 {
-    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
-    if (_running && _started) {
-        _started = false;
-    }
-
-    return _running && _started;
 }
 
 template <class NotificationClass>
-bool NotifyTimer<NotificationClass>::isStarted()
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart,
+        t_notificationcallback<NotificationClass> callback, NotificationClass* obj, const ThreadOptions& options, IClock& clock)
+        : _callback(callback)
+        , _obj(obj)
+        , _timer(interval, delayedStart, [this] { run(false); }, options, clock)
 {
-    std::lock_guard<std::mutex> lockGuard(_cv_mtx); // achieves adhearing to memory barries
-    return _started;
 }
 
 template <class NotificationClass>
-std::chrono::milliseconds NotifyTimer<NotificationClass>::getDelayedStart() const
+NotifyTimer<NotificationClass>::NotifyTimer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, bool notifyAllThreads,
+        const ThreadOptions& options, IClock& clock)
+        : _callback(nullptr)
+        , _obj(nullptr)
+        , _timer(interval, delayedStart, [this, notifyAllThreads] { run(notifyAllThreads); }, options, clock)
 {
-    return _msDelayedStart;
 }
 
 template <class NotificationClass>
-std::chrono::milliseconds NotifyTimer<NotificationClass>::getInterval() const
+void NotifyTimer<NotificationClass>::run(bool notifyAllThreads)
 {
-    return _msInterval;
+    if (_obj != nullptr) {
+        (_obj->*_callback)();
+    } else {
+        notifyEveryCV(notifyAllThreads);
+    }
 }
 
 } /* namespace essentials */
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace essentials
+{
+
+enum class SchedulingMode
+{
+    FIXED_RATE, /** < Deadlines are multiples of the interval after the first one, so they do not drift. */
+    FIXED_DELAY /** < Each deadline is one interval after the previous callback returned. */
+};
+
+/**
+ * Determines what a fixed-rate timer does with ticks whose deadline already
+ * passed when the previous callback returned.
+ */
+enum class OverrunPolicy
+{
+    SKIP,     /** < Drops the missed ticks and waits for the next deadline in the future. */
+    CATCH_UP, /** < Runs every missed tick, back to back, until the timer is on time again. */
+    COALESCE  /** < Runs a single callback right away for all missed ticks. */
+};
+
+/**
+ * Computes the deadlines of a periodic timer on the steady clock and counts
+ * the ticks that could not be run on time.
+ */
+class PeriodicSchedule
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PeriodicSchedule(std::chrono::nanoseconds interval = std::chrono::nanoseconds(0), SchedulingMode mode = SchedulingMode::FIXED_RATE,
+            OverrunPolicy policy = OverrunPolicy::SKIP)
+            : _interval(interval)
+            , _mode(mode)
+            , _policy(policy)
+            , _tickIndex(0)
+            , _countedIndex(0)
+            , _missedTicks(0)
+    {
+    }
+
+    void configure(std::chrono::nanoseconds interval, SchedulingMode mode, OverrunPolicy policy)
+    {
+        _interval = interval;
+        _mode = mode;
+        _policy = policy;
+    }
+
+    /**
+     * Restarts the schedule with the given deadline for its first tick.
+     */
+    void start(Clock::time_point firstDeadline)
+    {
+        _start = firstDeadline;
+        _deadline = firstDeadline;
+        _tickIndex = 0;
+        _countedIndex = 0;
+    }
+
+    /**
+     * Moves to the deadline of the tick following the callback that returned at the given point in time.
+     * @return The number of ticks that were missed since the last call.
+     */
+    uint64_t advance(Clock::time_point callbackEnd)
+    {
+        if (_interval.count() <= 0) {
+            return 0;
+        }
+        if (_mode == SchedulingMode::FIXED_DELAY) {
+            _deadline = callbackEnd + _interval;
+            return 0;
+        }
+
+        uint64_t next = _tickIndex + 1;
+        if (deadlineOf(next) > callbackEnd) {
+            _tickIndex = next;
+            _deadline = deadlineOf(next);
+            return 0;
+        }
+
+        // the index of the last tick, whose deadline already passed
+        uint64_t last = static_cast<uint64_t>((callbackEnd - _start) / _interval);
+        uint64_t missed = last - std::max(_tickIndex, _countedIndex);
+        _countedIndex = last;
+        _missedTicks += missed;
+        switch (_policy) {
+        case OverrunPolicy::SKIP:
+            _tickIndex = last + 1;
+            break;
+        case OverrunPolicy::CATCH_UP:
+            _tickIndex = next;
+            break;
+        case OverrunPolicy::COALESCE:
+            _tickIndex = last;
+            break;
+        }
+        _deadline = deadlineOf(_tickIndex);
+        return missed;
+    }
+
+    Clock::time_point getDeadline() const { return _deadline; }
+    std::chrono::nanoseconds getInterval() const { return _interval; }
+    SchedulingMode getMode() const { return _mode; }
+    OverrunPolicy getPolicy() const { return _policy; }
+    /**
+     * The number of ticks, whose deadline passed before they could be run. Depending on the
+     * overrun policy, they were dropped, run late, or folded into a single callback.
+     */
+    uint64_t getMissedTicks() const { return _missedTicks; }
+
+private:
+    Clock::time_point deadlineOf(uint64_t tickIndex) const { return _start + _interval * static_cast<int64_t>(tickIndex); }
+
+    std::chrono::nanoseconds _interval;
+    SchedulingMode _mode;
+    OverrunPolicy _policy;
+    Clock::time_point _start;    /** < The deadline of the first tick after the last start. */
+    Clock::time_point _deadline; /** < The deadline of the next tick. */
+    uint64_t _tickIndex;         /** < The index of the next tick, counted from the start. */
+    uint64_t _countedIndex;      /** < The index up to which missed ticks have been counted. */
+    std::atomic<uint64_t> _missedTicks;
+};
+
+} /* namespace essentials */
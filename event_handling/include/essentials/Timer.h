@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Clock.h"
+#include "ConfiguredThread.h"
+#include "IExecutor.h"
+#include "InplaceFunction.h"
+#include "LatencyHistogram.h"
+#include "PeriodicSchedule.h"
+#include "TimerService.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace essentials
+{
+
+/**
+ * The callback of a Timer. Lambdas with up to 48 bytes of captured state are stored without allocation.
+ */
+using TimerCallback = InplaceFunction<void()>;
+
+/**
+ * The Timer allows to have any callable be called in a fixed interval. The calling
+ * is delayed after each start by the given delay. Deadlines are absolute points in
+ * time on the steady clock, see PeriodicSchedule for the available scheduling modes
+ * and overrun policies.
+ *
+ * By default, each Timer runs its own thread. Timers constructed with a TimerService
+ * share the thread of that service instead and must be destroyed before the service.
+ * Timers run on the SteadyClock, unless another clock is given, either directly or
+ * through the service.
+ */
+class Timer
+{
+public:
+    /**
+     * Intervals and delays of any std::chrono::duration are accepted, they are stored as nanoseconds.
+     */
+    Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback);
+    Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, IClock& clock);
+    /**
+     * Creates the thread of the timer with the given options, e.g., a real-time priority.
+     * @throws std::system_error, if the options could not be applied, e.g., because of missing permissions.
+     */
+    Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, const ThreadOptions& options,
+            IClock& clock = SteadyClock::getInstance());
+    Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, TimerService& service);
+    ~Timer();
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    /**
+     * Sets the timer to run.
+     * @return True, if the timer will run after this call. False, otherwise.
+     */
+    bool start();
+    /**
+     * Sets the timer to stop.
+     * @return True, if the timer will anyways run after this call. False, otherwise.
+     */
+    bool stop();
+    /**
+     * Allows to get the running state of the timer.
+     * @return True, if the timer is set to run. False, otherwise.
+     */
+    bool isStarted();
+    template <class Duration = std::chrono::milliseconds>
+    Duration getDelayedStart() const
+    {
+        return std::chrono::duration_cast<Duration>(_delayedStart);
+    }
+    template <class Duration = std::chrono::milliseconds>
+    Duration getInterval() const
+    {
+        return std::chrono::duration_cast<Duration>(_interval);
+    }
+    /**
+     * Sets how long before each deadline the timer stops sleeping and spins on the clock
+     * instead, which makes high-rate timers hit their deadlines more precisely. A few tens
+     * of microseconds are usually enough. It is zero by default and only applies to timers
+     * with their own thread, timers of a TimerService are bound to the resolution of the service.
+     */
+    void setSpinThreshold(std::chrono::nanoseconds threshold);
+    std::chrono::nanoseconds getSpinThreshold();
+    /**
+     * Sets the scheduling mode, which is FIXED_RATE by default. Takes effect with the next start.
+     */
+    void setSchedulingMode(SchedulingMode mode);
+    SchedulingMode getSchedulingMode();
+    /**
+     * Sets the overrun policy of fixed-rate timers, which is SKIP by default. Takes effect with the next start.
+     */
+    void setOverrunPolicy(OverrunPolicy policy);
+    OverrunPolicy getOverrunPolicy();
+    /**
+     * @return The number of ticks, whose deadline passed before the previous callback returned,
+     * plus the ticks dropped, because the executor still ran the previous callback.
+     */
+    uint64_t getMissedTicks() const;
+    /**
+     * Sets the executor the callback is handed to, so the timing thread does not wait for it.
+     * A tick is dropped, if the callback of the previous tick has not returned, yet.
+     * The executor must outlive the timer.
+     */
+    void setExecutor(IExecutor* executor);
+    /**
+     * Starts recording the lateness of each callback compared to its deadline and
+     * the duration of each callback. The statistics live as long as the timer.
+     */
+    void enableStatistics();
+    /**
+     * @return The recorded statistics, or nullptr if they are not enabled.
+     */
+    TimerStatistics* getStatistics() const;
+
+private:
+    void run(); /** < The method executed by the timer thread */
+    void fire(IClock::time_point deadline);
+    void call(IClock::time_point deadline);
+
+    IClock& _clock;
+    std::mutex _cv_mtx;
+    std::condition_variable _cv;
+    TimerCallback _callback;
+    bool _running;                           /** < Is always true except when the timer is shutting down. */
+    bool _started;                           /** < True, if the Timer is active. False, otherwise. */
+    std::chrono::nanoseconds _interval;      /** < The time between two calls to the callback. */
+    std::chrono::nanoseconds _delayedStart;  /** < The time between (re)starting the Timer and the first callback call. */
+    std::chrono::nanoseconds _spinThreshold; /** < The time before each deadline, which is spent spinning instead of sleeping. */
+    SchedulingMode _mode;
+    OverrunPolicy _policy;
+    PeriodicSchedule _schedule; /** < The deadlines of this timer, if it runs its own thread. */
+    uint64_t _startCount;       /** < Tells the timer thread that the schedule was restarted while it called the callback. */
+    IExecutor* _executor;
+    bool _inFlight; /** < True, while the executor runs the callback. */
+    std::atomic<uint64_t> _droppedTicks;
+    std::atomic<TimerStatistics*> _statistics;
+    TimerService* _service;             /** < The service driving this timer, or nullptr if it runs its own thread. */
+    std::unique_ptr<TimerEntry> _entry; /** < The entry of this timer in the service. */
+    std::unique_ptr<ConfiguredThread> _runThread;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Clock.h"
+#include "ConfiguredThread.h"
+#include "Timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * Runs periodic callbacks from a single thread with as few wake-ups as possible.
+ * The deadlines of all members are multiples of their interval since the creation
+ * of the group, so members with related intervals, e.g., 10 ms, 20 ms and 50 ms,
+ * are due at the same time and fire in one wake-up. A member with slack may be
+ * delayed by up to its slack to the next base tick of the group, which merges it
+ * with the other members due on that tick.
+ *
+ * Missed deadlines are skipped. The callbacks are called in the order of adding
+ * and should return quickly, because they delay each other.
+ */
+class TimerGroup
+{
+public:
+    explicit TimerGroup(std::chrono::nanoseconds baseTick, IClock& clock = SteadyClock::getInstance());
+    /**
+     * @throws std::system_error, if the thread options could not be applied, see Timer.
+     */
+    TimerGroup(std::chrono::nanoseconds baseTick, const ThreadOptions& options, IClock& clock = SteadyClock::getInstance());
+    ~TimerGroup();
+    TimerGroup(const TimerGroup&) = delete;
+    TimerGroup& operator=(const TimerGroup&) = delete;
+
+    /**
+     * Adds a member, which fires every interval, but at most slack after its deadline.
+     * @return The id of the member.
+     */
+    int add(std::chrono::nanoseconds interval, TimerCallback callback, std::chrono::nanoseconds slack = std::chrono::nanoseconds(0));
+    /**
+     * Removes the member. If its callback is running, this waits for it to return,
+     * unless it is called from a callback of the group.
+     * @return False, if there is no such member.
+     */
+    bool remove(int id);
+    std::chrono::nanoseconds getBaseTick() const;
+    /**
+     * @return The number of times the group woke up to fire due members.
+     */
+    uint64_t getWakeUpCount();
+
+private:
+    struct Member
+    {
+        int id;
+        std::chrono::nanoseconds interval;
+        std::chrono::nanoseconds slack;
+        TimerCallback callback;
+        IClock::time_point deadline;
+        std::atomic<bool> removed; /** < Set by a callback, which removes a member of the running wake-up. */
+    };
+
+    void run(); /** < The method executed by the thread of the group */
+    IClock::time_point nextDeadline(const Member& member, IClock::time_point now) const;
+    IClock::time_point fireTime(const Member& member) const;
+
+    IClock& _clock;
+    const std::chrono::nanoseconds _baseTick;
+    const IClock::time_point _epoch; /** < The phase all deadlines are aligned to. */
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::vector<std::unique_ptr<Member>> _members;
+    int _nextId;
+    uint64_t _wakeUpCount;
+    uint64_t _changeCount; /** < Lets the thread recompute its wake-up time after adding a member. */
+    bool _firing;
+    bool _running;
+    std::thread::id _threadId;
+    std::unique_ptr<ConfiguredThread> _thread;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Clock.h"
+#include "ConfiguredThread.h"
+#include "InplaceFunction.h"
+#include "PeriodicSchedule.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace essentials
+{
+
+class TimerService;
+
+/**
+ * Node of the intrusive lists of the TimerService, so that linking and
+ * unlinking a timer never allocates and is O(1).
+ */
+struct TimerLink
+{
+    TimerLink* prev = this;
+    TimerLink* next = this;
+};
+
+/**
+ * A timer that is driven by a TimerService. The entry is owned by the
+ * user of the service and must be cancelled before it is destroyed.
+ */
+class TimerEntry : private TimerLink
+{
+public:
+    explicit TimerEntry(InplaceFunction<void()> callback);
+    TimerEntry(const TimerEntry&) = delete;
+    TimerEntry& operator=(const TimerEntry&) = delete;
+    uint64_t getMissedTicks() const { return _schedule.getMissedTicks(); }
+    /**
+     * The deadline of the current tick, while the callback is executed.
+     */
+    IClock::time_point getDeadline() const { return _schedule.getDeadline(); }
+
+private:
+    friend class TimerService;
+    InplaceFunction<void()> _callback;
+    PeriodicSchedule _schedule; /** < Provides the deadline of the next callback call, the interval is zero for one-shot entries. */
+    uint64_t _expiryTick; /** < The tick of the deadline, which may be beyond the range of the wheel. */
+    int _level;           /** < The level of the wheel holding the entry, or -1, if it is not in the wheel. */
+    bool _active;      /** < True, between schedule and cancel. */
+    bool _firing;      /** < True, while the service thread executes the callback. */
+    bool _rescheduled; /** < True, if the entry was scheduled again while firing. */
+};
+
+/**
+ * The TimerService drives many timers from a single thread. The timers are kept
+ * in a hierarchical timing wheel, so scheduling and cancelling a timer is O(1),
+ * independent of the number of timers. The service thread only wakes up for
+ * ticks with due timers and once per revolution of the lowest wheel level.
+ */
+class TimerService
+{
+public:
+    explicit TimerService(std::chrono::nanoseconds resolution = std::chrono::milliseconds(1), IClock& clock = SteadyClock::getInstance());
+    /**
+     * Creates the service thread with the given options, e.g., a real-time priority.
+     * @throws std::system_error, if the options could not be applied, e.g., because of missing permissions.
+     */
+    TimerService(std::chrono::nanoseconds resolution, const ThreadOptions& options, IClock& clock = SteadyClock::getInstance());
+    ~TimerService();
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * Schedules the entry to fire after the given delay and, if the interval is
+     * not zero, every interval afterwards. A scheduled entry is rescheduled.
+     * Deadlines are rounded up to the resolution of the service.
+     */
+    void schedule(TimerEntry* entry, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval,
+            SchedulingMode mode = SchedulingMode::FIXED_RATE, OverrunPolicy policy = OverrunPolicy::SKIP);
+    /**
+     * Removes the entry from the service. If its callback is executed right now and
+     * waitForCallback is set, this waits for the callback to return, unless it is
+     * called from the callback itself. Entries must only be destroyed after such a call.
+     */
+    void cancel(TimerEntry* entry, bool waitForCallback = true);
+    std::chrono::nanoseconds getResolution() const;
+    IClock& getClock() const;
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+
+    void run(); /** < The method executed by the service thread */
+    uint64_t toTick(IClock::time_point timePoint) const;
+    IClock::time_point toTimePoint(uint64_t tick) const;
+    uint64_t nextWakeUpTick() const;
+    void processTick(uint64_t tick);
+    void insert(TimerEntry* entry);
+    void detach(TimerEntry* entry);
+    void cascade(int level, uint64_t tick);
+    static void link(TimerLink* head, TimerLink* link);
+    static void unlink(TimerLink* link);
+    static bool isEmpty(const TimerLink& head) { return head.next == &head; }
+
+    IClock& _clock;
+    const std::chrono::nanoseconds _resolution;
+    const IClock::time_point _epoch;
+    std::mutex _mtx;
+    std::condition_variable _cv;           /** < Wakes up the service thread, if an earlier timer was scheduled. */
+    std::condition_variable _firingDoneCV; /** < Notifies cancel calls waiting for a callback to return. */
+    TimerLink _wheel[LEVELS][SLOTS];
+    size_t _levelCounts[LEVELS]; /** < The number of entries per level, so that empty levels are skipped. */
+    TimerLink _expired; /** < Entries of the current tick, whose callbacks have not been called, yet. */
+    uint64_t _currentTick;
+    uint64_t _nextWakeUpTick;
+    size_t _scheduledCount;
+    bool _running;
+    std::thread::id _serviceThreadId;
+    std::unique_ptr<ConfiguredThread> _serviceThread;
+};
+
+} /* namespace essentials */
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace essentials
+{
+
+/**
+ * Tells the CPU that the calling thread spins, which saves power and frees
+ * resources for a sibling hyper-thread.
+ */
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * Waits in three phases: spinning, yielding and parking. A fire that comes within
+ * a few microseconds is then picked up without the cost of a futex sleep and wake-up,
+ * while longer waits still release the CPU.
+ *
+ * The number of spins tunes itself: waits that succeed while spinning raise it to
+ * twice the spins they needed, waits that succeed while yielding double it, as a
+ * little more spinning would have been enough, and waits that end up parking halve
+ * it. Consumers that are usually served quickly therefore spin, consumers that are
+ * not stop spinning.
+ * The policy may be shared by threads, but tunes best per consumer.
+ */
+class AdaptiveWaitPolicy
+{
+public:
+    explicit AdaptiveWaitPolicy(uint32_t minSpins = 16, uint32_t maxSpins = 16384, uint32_t yields = 4)
+            : _minSpins(minSpins)
+            , _maxSpins(maxSpins < minSpins ? minSpins : maxSpins)
+            , _yields(yields)
+            , _spinLimit(minSpins)
+    {
+    }
+
+    /**
+     * Waits until ready returns true. After spinning and yielding, park is called,
+     * which blocks until ready or a timeout and returns whether it is ready.
+     * @return The result of ready or park.
+     */
+    template <class Ready, class Park>
+    bool wait(Ready&& ready, Park&& park)
+    {
+        uint32_t spinLimit = _spinLimit.load(std::memory_order_relaxed);
+        for (uint32_t spins = 0; spins < spinLimit; ++spins) {
+            if (ready()) {
+                uint32_t raised = spins * 2 > _maxSpins ? _maxSpins : spins * 2;
+                if (raised > spinLimit) {
+                    _spinLimit.store(raised, std::memory_order_relaxed);
+                }
+                return true;
+            }
+            cpuRelax();
+        }
+        for (uint32_t yields = 0; yields < _yields; ++yields) {
+            std::this_thread::yield();
+            if (ready()) {
+                _spinLimit.store(spinLimit * 2 > _maxSpins ? _maxSpins : spinLimit * 2, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        // the spinning was in vain
+        uint32_t lowered = spinLimit / 2 < _minSpins ? _minSpins : spinLimit / 2;
+        _spinLimit.store(lowered, std::memory_order_relaxed);
+        return park();
+    }
+
+    uint32_t getSpinLimit() const { return _spinLimit.load(std::memory_order_relaxed); }
+
+private:
+    const uint32_t _minSpins;
+    const uint32_t _maxSpins;
+    const uint32_t _yields;
+    std::atomic<uint32_t> _spinLimit;
+};
+
+} /* namespace essentials */
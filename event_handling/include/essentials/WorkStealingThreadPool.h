@@ -0,0 +1,57 @@
+#pragma once
+
+#include "IExecutor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * A thread pool with one task queue per worker. Tasks submitted by a worker
+ * are put into its own queue and taken in LIFO order, tasks from other threads
+ * are distributed round robin. Idle workers steal from the front of the other
+ * queues before they go to sleep.
+ */
+class WorkStealingThreadPool : public IExecutor
+{
+public:
+    /**
+     * @param threadCount The number of workers, 0 creates one per hardware thread.
+     */
+    explicit WorkStealingThreadPool(unsigned int threadCount = 0);
+    ~WorkStealingThreadPool() override;
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    void execute(std::function<void()> task) override;
+    unsigned int getThreadCount() const;
+
+private:
+    struct Worker
+    {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    void run(unsigned int index); /** < The method executed by each worker thread */
+    bool popOwn(unsigned int index, std::function<void()>& task);
+    bool steal(unsigned int thiefIndex, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<unsigned int> _nextWorker;
+    std::atomic<size_t> _pendingTasks;
+    std::atomic<unsigned int> _idleWorkers;
+    std::mutex _idleMtx;
+    std::condition_variable _idleCV;
+    bool _running;
+};
+
+} /* namespace essentials */
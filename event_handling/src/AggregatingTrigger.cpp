@@ -0,0 +1,166 @@
+#include "essentials/AggregatingTrigger.h"
+
+#include <algorithm>
+
+namespace essentials
+{
+
+AggregatingTrigger::AggregatingTrigger()
+        : _pendingEvents(0)
+        , _deliveredEvents(0)
+        , _coalescedCount(0)
+        , _deliveryCount(0)
+        , _notifyAllThreads(false)
+{
+}
+
+uint64_t AggregatingTrigger::takeEventCount()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    uint64_t count = _deliveredEvents;
+    _deliveredEvents = 0;
+    return count;
+}
+
+uint64_t AggregatingTrigger::getCoalescedCount()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    return _coalescedCount;
+}
+
+uint64_t AggregatingTrigger::getDeliveryCount()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    return _deliveryCount;
+}
+
+uint64_t AggregatingTrigger::record(bool notifyAllThreads)
+{
+    _notifyAllThreads = notifyAllThreads;
+    return ++_pendingEvents;
+}
+
+void AggregatingTrigger::deliver()
+{
+    if (_pendingEvents == 0) {
+        return;
+    }
+    _deliveredEvents += _pendingEvents;
+    _coalescedCount += _pendingEvents - 1;
+    _pendingEvents = 0;
+    _deliveryCount++;
+    notifyEveryCV(_notifyAllThreads);
+}
+
+DebounceTrigger::DebounceTrigger(std::chrono::nanoseconds window, TimerService& service)
+        : _window(window)
+        , _service(service)
+        , _entry([this] {
+            std::lock_guard<std::mutex> lockGuard(_mtx);
+            deliver();
+        })
+{
+}
+
+DebounceTrigger::~DebounceTrigger()
+{
+    _service.cancel(&_entry);
+}
+
+void DebounceTrigger::run(bool notifyAllThreads)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    record(notifyAllThreads);
+    // every run pushes the delivery back by a whole window
+    _service.schedule(&_entry, _window, std::chrono::nanoseconds(0));
+}
+
+ThrottleTrigger::ThrottleTrigger(std::chrono::nanoseconds interval, TimerService& service)
+        : _interval(interval)
+        , _service(service)
+        , _entry([this] { flush(); })
+        , _flushScheduled(false)
+        , _lastDelivery(service.getClock().now() - interval)
+{
+}
+
+ThrottleTrigger::~ThrottleTrigger()
+{
+    _service.cancel(&_entry);
+}
+
+void ThrottleTrigger::run(bool notifyAllThreads)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    record(notifyAllThreads);
+    if (_flushScheduled) {
+        return;
+    }
+    auto now = _service.getClock().now();
+    auto nextDelivery = _lastDelivery + _interval;
+    if (now >= nextDelivery) {
+        _lastDelivery = now;
+        deliver();
+    } else {
+        _flushScheduled = true;
+        _service.schedule(&_entry, nextDelivery - now, std::chrono::nanoseconds(0));
+    }
+}
+
+void ThrottleTrigger::flush()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    _flushScheduled = false;
+    _lastDelivery = _service.getClock().now();
+    deliver();
+}
+
+CoalescingTrigger::CoalescingTrigger(uint64_t batchSize)
+        : _batchSize(std::max<uint64_t>(batchSize, 1))
+        , _maxDelay(0)
+        , _service(nullptr)
+        , _entry([this] { flush(); })
+        , _flushScheduled(false)
+{
+}
+
+CoalescingTrigger::CoalescingTrigger(uint64_t batchSize, std::chrono::nanoseconds maxDelay, TimerService& service)
+        : _batchSize(std::max<uint64_t>(batchSize, 1))
+        , _maxDelay(maxDelay)
+        , _service(&service)
+        , _entry([this] { flush(); })
+        , _flushScheduled(false)
+{
+}
+
+CoalescingTrigger::~CoalescingTrigger()
+{
+    if (_service) {
+        _service->cancel(&_entry);
+    }
+}
+
+void CoalescingTrigger::run(bool notifyAllThreads)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    uint64_t pending = record(notifyAllThreads);
+    if (pending >= _batchSize) {
+        if (_flushScheduled) {
+            _flushScheduled = false;
+            _service->cancel(&_entry, false);
+        }
+        deliver();
+    } else if (_service && !_flushScheduled) {
+        _flushScheduled = true;
+        _service->schedule(&_entry, _maxDelay, std::chrono::nanoseconds(0));
+    }
+}
+
+void CoalescingTrigger::flush()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    _flushScheduled = false;
+    deliver();
+}
+
+} /* namespace essentials */
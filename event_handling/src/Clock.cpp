@@ -0,0 +1,70 @@
+#include "essentials/Clock.h"
+
+#include <algorithm>
+
+namespace essentials
+{
+
+SteadyClock& SteadyClock::getInstance()
+{
+    static SteadyClock instance;
+    return instance;
+}
+
+ManualClock::ManualClock(time_point start)
+        : _nowNs(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count())
+{
+}
+
+IClock::time_point ManualClock::now() const
+{
+    return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::nanoseconds(_nowNs.load())));
+}
+
+bool ManualClock::waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, time_point deadline, const std::function<bool()>& predicate)
+{
+    // the mutex of the waiter is released for (de)registering, so the lock order stays the same as in advance
+    Waiter waiter{&cv, lock.mutex()};
+    lock.unlock();
+    {
+        std::lock_guard<std::mutex> lockGuard(_waitersMtx);
+        _waiters.push_back(&waiter);
+    }
+    lock.lock();
+
+    // advance locks the mutex of the waiter before notifying, so no wake-up gets lost in between
+    while (!predicate() && now() < deadline) {
+        cv.wait(lock);
+    }
+
+    lock.unlock();
+    {
+        std::lock_guard<std::mutex> lockGuard(_waitersMtx);
+        _waiters.erase(std::find(_waiters.begin(), _waiters.end(), &waiter));
+    }
+    lock.lock();
+    return predicate();
+}
+
+void ManualClock::advance(std::chrono::nanoseconds duration)
+{
+    std::lock_guard<std::mutex> lockGuard(_waitersMtx);
+    _nowNs += duration.count();
+    for (Waiter* waiter : _waiters) {
+        std::lock_guard<std::mutex> waiterGuard(*waiter->mtx);
+        waiter->cv->notify_all();
+    }
+}
+
+void ManualClock::setTime(time_point time)
+{
+    advance(time - now());
+}
+
+size_t ManualClock::getWaiterCount()
+{
+    std::lock_guard<std::mutex> lockGuard(_waitersMtx);
+    return _waiters.size();
+}
+
+} /* namespace essentials */
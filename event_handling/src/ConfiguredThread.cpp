@@ -0,0 +1,163 @@
+#include "essentials/ConfiguredThread.h"
+
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+namespace essentials
+{
+
+namespace
+{
+/**
+ * Shared between the creating and the created thread until the latter reports its start.
+ */
+struct Startup
+{
+    const ThreadOptions& options;
+    std::function<void()> function;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done;
+    int error;
+    std::string what;
+};
+
+std::string describe(const ThreadOptions& options)
+{
+    switch (options.scheduling) {
+    case ThreadScheduling::FIFO:
+        return "SCHED_FIFO with priority " + std::to_string(options.priority);
+    case ThreadScheduling::ROUND_ROBIN:
+        return "SCHED_RR with priority " + std::to_string(options.priority);
+    default:
+        return "default scheduling";
+    }
+}
+
+void check(int error, const std::string& what)
+{
+    if (error != 0) {
+        throw std::system_error(error, std::system_category(), "ConfiguredThread: " + what);
+    }
+}
+
+/**
+ * Sets the attributes of the options and throws for the first one that fails.
+ */
+void configure(pthread_attr_t& attr, const ThreadOptions& options)
+{
+    if (options.stackSize > 0) {
+        check(pthread_attr_setstacksize(&attr, options.stackSize), "setting the stack size to " + std::to_string(options.stackSize) + " bytes");
+    }
+    if (!options.cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu : options.cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                check(EINVAL, "CPU " + std::to_string(cpu) + " is out of range");
+            }
+            CPU_SET(cpu, &cpus);
+        }
+        check(pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus), "setting the CPU affinity");
+    }
+    if (options.scheduling != ThreadScheduling::DEFAULT) {
+        int policy = options.scheduling == ThreadScheduling::FIFO ? SCHED_FIFO : SCHED_RR;
+        sched_param param{};
+        param.sched_priority = options.priority;
+        check(pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED), "requesting explicit scheduling");
+        check(pthread_attr_setschedpolicy(&attr, policy), "setting " + describe(options));
+        check(pthread_attr_setschedparam(&attr, &param), "setting " + describe(options));
+    }
+}
+} // namespace
+
+ConfiguredThread::ConfiguredThread(const ThreadOptions& options, std::function<void()> function)
+        : _joined(false)
+{
+    Startup startup{options, std::move(function), {}, {}, false, 0, {}};
+    pthread_attr_t attr;
+    check(pthread_attr_init(&attr), "initialising the thread attributes");
+    int error = 0;
+    try {
+        configure(attr, options);
+        error = pthread_create(&_thread, &attr, &ConfiguredThread::start, &startup);
+    } catch (...) {
+        pthread_attr_destroy(&attr);
+        throw;
+    }
+    pthread_attr_destroy(&attr);
+    if (error == EPERM) {
+        check(error, describe(options) + " is not permitted, it requires CAP_SYS_NICE or a sufficient RLIMIT_RTPRIO");
+    }
+    check(error, "creating the thread with " + describe(options));
+
+    std::unique_lock<std::mutex> lck(startup.mtx);
+    startup.cv.wait(lck, [&startup] { return startup.done; });
+    if (startup.error != 0) {
+        lck.unlock();
+        pthread_join(_thread, nullptr);
+        _joined = true;
+        check(startup.error, startup.what);
+    }
+}
+
+ConfiguredThread::~ConfiguredThread()
+{
+    join();
+}
+
+void ConfiguredThread::join()
+{
+    if (!_joined) {
+        pthread_join(_thread, nullptr);
+        _joined = true;
+    }
+}
+
+void* ConfiguredThread::start(void* startupPtr)
+{
+    Startup& startup = *static_cast<Startup*>(startupPtr);
+    std::function<void()> function = std::move(startup.function);
+    int error = 0;
+    std::string what;
+    bool lockStack = startup.options.lockStack;
+    void* stack = nullptr;
+    size_t stackSize = 0;
+    if (lockStack) {
+        pthread_attr_t attr;
+        if ((error = pthread_getattr_np(pthread_self(), &attr)) == 0) {
+            error = pthread_attr_getstack(&attr, &stack, &stackSize);
+            pthread_attr_destroy(&attr);
+        }
+        if (error == 0 && mlock(stack, stackSize) != 0) {
+            error = errno;
+            what = "locking the stack of " + std::to_string(stackSize) + " bytes, check RLIMIT_MEMLOCK";
+        } else if (error != 0) {
+            what = "determining the stack of the thread";
+        }
+    }
+    {
+        // the creating thread destroys the startup once it got the result
+        std::lock_guard<std::mutex> lockGuard(startup.mtx);
+        startup.error = error;
+        startup.what = what;
+        startup.done = true;
+        startup.cv.notify_all();
+    }
+    if (error == 0) {
+        function();
+        if (lockStack) {
+            // the stack might be reused for another thread
+            munlock(stack, stackSize);
+        }
+    }
+    return nullptr;
+}
+
+} /* namespace essentials */
@@ -0,0 +1,290 @@
+#include "essentials/EventLoop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+
+namespace essentials
+{
+
+namespace
+{
+const int MAX_EVENTS = 64;
+
+uint64_t toEventData(int fd, uint32_t generation)
+{
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+/**
+ * Reads the counter of an eventfd or timerfd, so it is not reported again.
+ */
+void drain(int fd)
+{
+    uint64_t count;
+    while (::read(fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+    }
+}
+} // namespace
+
+EventLoop::Watch::~Watch()
+{
+    if (type != WatchType::FD) {
+        ::close(fd);
+    }
+}
+
+EventLoop::EventLoop()
+        : _nextGeneration(0)
+        , _running(true)
+{
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epollFd < 0) {
+        throw std::system_error(errno, std::system_category(), "EventLoop: epoll_create1");
+    }
+    _wakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_wakeUpFd < 0) {
+        int error = errno;
+        ::close(_epollFd);
+        throw std::system_error(error, std::system_category(), "EventLoop: eventfd");
+    }
+    auto watch = std::make_shared<Watch>();
+    watch->fd = _wakeUpFd;
+    watch->type = WatchType::WAKE_UP;
+    add(std::move(watch), EPOLLIN);
+
+    // see Timer: all members are initialised before the thread starts
+    _loopThread = std::thread(&EventLoop::run, this);
+}
+
+EventLoop::~EventLoop()
+{
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        _running = false;
+    }
+    uint64_t one = 1;
+    if (::write(_wakeUpFd, &one, sizeof(one)) < 0) {
+        perror("EventLoop: write");
+    }
+    _loopThread.join();
+
+    for (auto& entry : _watches) {
+        const Watch& watch = *entry.second;
+        if (watch.type == WatchType::TRIGGER) {
+            watch.trigger->unregisterCallback(watch.callbackId);
+            std::lock_guard<std::mutex> lockGuard(watch.link->mtx);
+            watch.link->fd = -1;
+        }
+    }
+    _watches.clear();
+    ::close(_epollFd);
+}
+
+bool EventLoop::watch(int fd, uint32_t events, FdCallback callback)
+{
+    auto watch = std::make_shared<Watch>();
+    watch->fd = fd;
+    watch->type = WatchType::FD;
+    watch->fdCallback = std::move(callback);
+    return add(std::move(watch), events);
+}
+
+bool EventLoop::unwatch(int fd)
+{
+    return remove(fd, WatchType::FD) != nullptr;
+}
+
+int EventLoop::addTimer(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, Callback callback)
+{
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0) {
+        perror("EventLoop: timerfd_create");
+        return -1;
+    }
+    auto watch = std::make_shared<Watch>();
+    watch->fd = timerFd;
+    watch->type = WatchType::TIMER;
+    watch->callback = std::move(callback);
+    if (!add(std::move(watch), EPOLLIN)) {
+        return -1;
+    }
+    if (!setTime(timerFd, delay, interval)) {
+        removeTimer(timerFd);
+        return -1;
+    }
+    return timerFd;
+}
+
+bool EventLoop::rearmTimer(int timerId, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    auto watch = _watches.find(timerId);
+    if (watch == _watches.end() || watch->second->type != WatchType::TIMER) {
+        return false;
+    }
+    return setTime(timerId, delay, interval);
+}
+
+bool EventLoop::removeTimer(int timerId)
+{
+    // the watch closes the descriptor, once the loop thread does not use it anymore
+    return remove(timerId, WatchType::TIMER) != nullptr;
+}
+
+int EventLoop::addTrigger(EventTrigger& trigger, Callback callback)
+{
+    int triggerFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (triggerFd < 0) {
+        perror("EventLoop: eventfd");
+        return -1;
+    }
+    auto link = std::make_shared<TriggerLink>();
+    link->fd = triggerFd;
+    auto watch = std::make_shared<Watch>();
+    watch->fd = triggerFd;
+    watch->type = WatchType::TRIGGER;
+    watch->callback = std::move(callback);
+    watch->link = link;
+    watch->trigger = &trigger;
+    // registered before the watch is visible, so removeTrigger always finds the id
+    watch->callbackId = trigger.registerCallback([link] {
+        std::lock_guard<std::mutex> lockGuard(link->mtx);
+        if (link->fd >= 0) {
+            uint64_t one = 1;
+            if (::write(link->fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+                perror("EventLoop: write");
+            }
+        }
+    });
+    if (!add(watch, EPOLLIN)) {
+        // the watch closes the descriptor after the callback stopped using it
+        trigger.unregisterCallback(watch->callbackId);
+        std::lock_guard<std::mutex> lockGuard(link->mtx);
+        link->fd = -1;
+        return -1;
+    }
+    return triggerFd;
+}
+
+bool EventLoop::removeTrigger(int triggerId)
+{
+    std::shared_ptr<Watch> watch = remove(triggerId, WatchType::TRIGGER);
+    if (!watch) {
+        return false;
+    }
+    watch->trigger->unregisterCallback(watch->callbackId);
+    std::lock_guard<std::mutex> lockGuard(watch->link->mtx);
+    watch->link->fd = -1;
+    return true;
+}
+
+bool EventLoop::add(std::shared_ptr<Watch> watch, uint32_t events)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    if (_watches.find(watch->fd) != _watches.end()) {
+        return false;
+    }
+    watch->generation = _nextGeneration++;
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = toEventData(watch->fd, watch->generation);
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, watch->fd, &event) < 0) {
+        perror("EventLoop: epoll_ctl");
+        return false;
+    }
+    int fd = watch->fd;
+    _watches.emplace(fd, std::move(watch));
+    return true;
+}
+
+std::shared_ptr<EventLoop::Watch> EventLoop::remove(int fd, WatchType type)
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    auto watch = _watches.find(fd);
+    if (watch == _watches.end() || watch->second->type != type) {
+        return nullptr;
+    }
+    std::shared_ptr<Watch> removed = std::move(watch->second);
+    _watches.erase(watch);
+    if (epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr) < 0) {
+        perror("EventLoop: epoll_ctl");
+    }
+    return removed;
+}
+
+void EventLoop::run()
+{
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+        int count = epoll_wait(_epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("EventLoop: epoll_wait");
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = static_cast<int>(static_cast<uint32_t>(events[i].data.u64));
+            uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+            std::shared_ptr<Watch> watch;
+            {
+                std::lock_guard<std::mutex> lockGuard(_mtx);
+                if (!_running) {
+                    return;
+                }
+                auto entry = _watches.find(fd);
+                // skips events of watches removed by a previous callback of this batch
+                if (entry == _watches.end() || entry->second->generation != generation) {
+                    continue;
+                }
+                watch = entry->second;
+            }
+            dispatch(*watch, events[i].events);
+        }
+    }
+}
+
+void EventLoop::dispatch(const Watch& watch, uint32_t events)
+{
+    switch (watch.type) {
+    case WatchType::FD:
+        watch.fdCallback(events);
+        break;
+    case WatchType::TIMER:
+    case WatchType::TRIGGER:
+        drain(watch.fd);
+        watch.callback();
+        break;
+    case WatchType::WAKE_UP:
+        drain(watch.fd);
+        break;
+    }
+}
+
+bool EventLoop::setTime(int timerFd, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval)
+{
+    // a zero delay would disarm the timer
+    if (delay.count() <= 0) {
+        delay = std::chrono::nanoseconds(1);
+    }
+    itimerspec spec{};
+    spec.it_value.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(delay).count();
+    spec.it_value.tv_nsec = (delay % std::chrono::seconds(1)).count();
+    spec.it_interval.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(interval).count();
+    spec.it_interval.tv_nsec = (interval % std::chrono::seconds(1)).count();
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) < 0) {
+        perror("EventLoop: timerfd_settime");
+        return false;
+    }
+    return true;
+}
+
+} /* namespace essentials */
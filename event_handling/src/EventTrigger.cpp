@@ -2,8 +2,92 @@
 
 namespace essentials
 {
+EventTrigger::~EventTrigger()
+{
+    delete _statistics.load();
+}
+
 void EventTrigger::run(bool notifyAll)
 {
+    if (_statistics.load(std::memory_order_relaxed)) {
+        _lastRunNs.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
     notifyEveryCV(notifyAll);
+    _broadcastEvent.run();
+
+    std::shared_ptr<const std::vector<RegisteredCallback>> callbacks;
+    IExecutor* executor;
+    {
+        std::lock_guard<std::mutex> lockGuard(_callbackMtx);
+        callbacks = _callbacks;
+        executor = _executor;
+    }
+    if (!callbacks) {
+        return;
+    }
+    for (auto& registered : *callbacks) {
+        if (executor) {
+            executor->execute(registered.callback);
+        } else {
+            registered.callback();
+        }
+    }
+}
+
+int EventTrigger::registerCallback(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lockGuard(_callbackMtx);
+    auto callbacks = _callbacks ? std::make_shared<std::vector<RegisteredCallback>>(*_callbacks) : std::make_shared<std::vector<RegisteredCallback>>();
+    callbacks->push_back(RegisteredCallback{_nextCallbackId, std::move(callback)});
+    _callbacks = std::move(callbacks);
+    return _nextCallbackId++;
+}
+
+bool EventTrigger::unregisterCallback(int callbackId)
+{
+    std::lock_guard<std::mutex> lockGuard(_callbackMtx);
+    if (!_callbacks) {
+        return false;
+    }
+    auto callbacks = std::make_shared<std::vector<RegisteredCallback>>();
+    callbacks->reserve(_callbacks->size());
+    for (const RegisteredCallback& registered : *_callbacks) {
+        if (registered.id != callbackId) {
+            callbacks->push_back(registered);
+        }
+    }
+    if (callbacks->size() == _callbacks->size()) {
+        return false;
+    }
+    _callbacks = std::move(callbacks);
+    return true;
+}
+
+void EventTrigger::setExecutor(IExecutor* executor)
+{
+    std::lock_guard<std::mutex> lockGuard(_callbackMtx);
+    _executor = executor;
+}
+void EventTrigger::enableStatistics()
+{
+    TriggerStatistics* expected = nullptr;
+    TriggerStatistics* statistics = new TriggerStatistics();
+    if (!_statistics.compare_exchange_strong(expected, statistics)) {
+        delete statistics;
+    }
+}
+
+TriggerStatistics* EventTrigger::getStatistics() const
+{
+    return _statistics.load();
+}
+
+void EventTrigger::recordWakeUp()
+{
+    TriggerStatistics* statistics = _statistics.load(std::memory_order_acquire);
+    if (statistics) {
+        auto lastRun = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(_lastRunNs.load(std::memory_order_relaxed)));
+        statistics->wakeUpLatency.record(std::chrono::steady_clock::now() - lastRun);
+    }
 }
 } // namespace essentials
@@ -0,0 +1,72 @@
+#include "essentials/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace essentials
+{
+
+const int LatencyHistogram::SUB_BUCKET_BITS;
+const int LatencyHistogram::SUB_BUCKETS;
+const int LatencyHistogram::BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+        : _sum(0)
+        , _max(0)
+{
+    for (auto& count : _counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot(bool reset)
+{
+    HistogramSnapshot snapshot;
+    snapshot.counts.resize(BUCKETS);
+    for (int i = 0; i < BUCKETS; i++) {
+        snapshot.counts[i] = reset ? _counts[i].exchange(0, std::memory_order_relaxed) : _counts[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    // sum and max are not taken atomically together with the counts, so they might include a few more values
+    if (reset) {
+        snapshot.sum = _sum.exchange(0, std::memory_order_relaxed);
+        snapshot.max = _max.exchange(0, std::memory_order_relaxed);
+    } else {
+        snapshot.sum = _sum.load(std::memory_order_relaxed);
+        snapshot.max = _max.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::getBucketLowerBound(int index)
+{
+    if (index < SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    int exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t subBucket = static_cast<uint64_t>(index % SUB_BUCKETS);
+    return (SUB_BUCKETS + subBucket) << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t HistogramSnapshot::getPercentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            if (static_cast<int>(i) + 1 >= LatencyHistogram::BUCKETS) {
+                return std::numeric_limits<uint64_t>::max();
+            }
+            return std::min(LatencyHistogram::getBucketLowerBound(static_cast<int>(i) + 1) - 1, max);
+        }
+    }
+    return max;
+}
+
+} /* namespace essentials */
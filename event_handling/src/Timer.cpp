@@ -0,0 +1,257 @@
+#include "essentials/Timer.h"
+#include "essentials/WaitPolicy.h"
+
+namespace essentials
+{
+
+Timer::Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback)
+        : Timer(interval, delayedStart, std::move(callback), SteadyClock::getInstance())
+{
+}
+
+Timer::Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, IClock& clock)
+        : Timer(interval, delayedStart, std::move(callback), ThreadOptions(), clock)
+{
+}
+
+Timer::Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, const ThreadOptions& options,
+        IClock& clock)
+        : _clock(clock)
+        , _callback(std::move(callback))
+        , _running(true)
+        , _started(false)
+        , _interval(interval)
+        , _delayedStart(delayedStart)
+        , _spinThreshold(0)
+        , _mode(SchedulingMode::FIXED_RATE)
+        , _policy(OverrunPolicy::SKIP)
+        , _startCount(0)
+        , _executor(nullptr)
+        , _inFlight(false)
+        , _droppedTicks(0)
+        , _statistics(nullptr)
+        , _service(nullptr)
+{
+    /**
+     * We initialise the thread in the body of the constructor
+     * because this guarantees to have all control variables
+     * for this thread initialised properly before it starts.
+     */
+    _runThread = std::make_unique<ConfiguredThread>(options, [this] { run(); });
+}
+
+Timer::Timer(std::chrono::nanoseconds interval, std::chrono::nanoseconds delayedStart, TimerCallback callback, TimerService& service)
+        : _clock(service.getClock())
+        , _callback(std::move(callback))
+        , _running(true)
+        , _started(false)
+        , _interval(interval)
+        , _delayedStart(delayedStart)
+        , _spinThreshold(0)
+        , _mode(SchedulingMode::FIXED_RATE)
+        , _policy(OverrunPolicy::SKIP)
+        , _startCount(0)
+        , _executor(nullptr)
+        , _inFlight(false)
+        , _droppedTicks(0)
+        , _statistics(nullptr)
+        , _service(&service)
+        , _entry(std::make_unique<TimerEntry>([this] { fire(_entry->getDeadline()); }))
+{
+}
+
+Timer::~Timer()
+{
+    {
+        std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+        _started = false;
+        _running = false;
+    }
+    if (_service) {
+        // waits for a running callback, so the entry is not used after this
+        _service->cancel(_entry.get());
+    } else {
+        _cv.notify_all();
+        _runThread->join();
+    }
+
+    // waits for a callback handed to the executor
+    std::unique_lock<std::mutex> lck(_cv_mtx);
+    _cv.wait(lck, [this] { return !_inFlight; });
+    delete _statistics.load();
+}
+
+void Timer::run()
+{
+    std::unique_lock<std::mutex> lck(_cv_mtx);
+    while (_running) {
+        _cv.wait(lck, [&] { return !_running || _started; });
+
+        if (!_running) // for destroying the timer
+            return;
+
+        while (_started) {
+            // absolute deadlines on a monotonic clock neither drift nor follow wall clock jumps
+            auto deadline = _schedule.getDeadline();
+            uint64_t startCount = _startCount;
+            if (_clock.waitUntil(lck, _cv, deadline - _spinThreshold, [&] { return !_started || _startCount != startCount; })) {
+                continue;
+            }
+            lck.unlock();
+            if (_spinThreshold.count() > 0) {
+                // the wake-up latency of the scheduler is larger than the remaining time
+                while (_clock.now() < deadline) {
+                    cpuRelax();
+                }
+            }
+            fire(deadline);
+            lck.lock();
+            if (_startCount == startCount) {
+                _schedule.advance(_clock.now());
+            }
+        }
+    }
+}
+
+void Timer::fire(IClock::time_point deadline)
+{
+    IExecutor* executor;
+    {
+        std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+        executor = _executor;
+        if (executor) {
+            if (_inFlight) {
+                _droppedTicks++;
+                return;
+            }
+            _inFlight = true;
+        }
+    }
+    if (!executor) {
+        call(deadline);
+        return;
+    }
+
+    executor->execute([this, deadline] {
+        call(deadline);
+        std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+        _inFlight = false;
+        _cv.notify_all();
+    });
+}
+
+void Timer::call(IClock::time_point deadline)
+{
+    TimerStatistics* statistics = _statistics.load(std::memory_order_acquire);
+    IClock::time_point start;
+    if (statistics) {
+        start = _clock.now();
+        statistics->lateness.record(start - deadline);
+    }
+
+    _callback();
+
+    if (statistics) {
+        statistics->callbackDuration.record(_clock.now() - start);
+    }
+}
+
+bool Timer::start()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    if (_running && !_started) {
+        _started = true;
+        _startCount++;
+        _schedule.configure(_interval, _mode, _policy);
+        _schedule.start(_clock.now() + _delayedStart);
+        if (_service) {
+            _service->schedule(_entry.get(), _delayedStart, _interval, _mode, _policy);
+        }
+    }
+    _cv.notify_all();
+    return _running && _started;
+}
+
+bool Timer::stop()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    if (_running && _started) {
+        _started = false;
+        if (_service) {
+            // does not wait for a running callback, which might call isStarted()
+            _service->cancel(_entry.get(), false);
+        }
+    }
+    _cv.notify_all();
+
+    return _running && _started;
+}
+
+bool Timer::isStarted()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx); // achieves adhearing to memory barries
+    return _started;
+}
+
+void Timer::setSpinThreshold(std::chrono::nanoseconds threshold)
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    _spinThreshold = threshold;
+}
+
+std::chrono::nanoseconds Timer::getSpinThreshold()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    return _spinThreshold;
+}
+
+void Timer::setSchedulingMode(SchedulingMode mode)
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    _mode = mode;
+}
+
+SchedulingMode Timer::getSchedulingMode()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    return _mode;
+}
+
+void Timer::setOverrunPolicy(OverrunPolicy policy)
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    _policy = policy;
+}
+
+OverrunPolicy Timer::getOverrunPolicy()
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    return _policy;
+}
+
+uint64_t Timer::getMissedTicks() const
+{
+    return (_service ? _entry->getMissedTicks() : _schedule.getMissedTicks()) + _droppedTicks;
+}
+
+void Timer::setExecutor(IExecutor* executor)
+{
+    std::lock_guard<std::mutex> lockGuard(_cv_mtx);
+    _executor = executor;
+}
+
+void Timer::enableStatistics()
+{
+    TimerStatistics* expected = nullptr;
+    TimerStatistics* statistics = new TimerStatistics();
+    if (!_statistics.compare_exchange_strong(expected, statistics)) {
+        delete statistics;
+    }
+}
+
+TimerStatistics* Timer::getStatistics() const
+{
+    return _statistics.load();
+}
+
+} /* namespace essentials */
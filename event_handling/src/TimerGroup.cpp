@@ -0,0 +1,157 @@
+#include "essentials/TimerGroup.h"
+
+#include <algorithm>
+
+namespace essentials
+{
+
+TimerGroup::TimerGroup(std::chrono::nanoseconds baseTick, IClock& clock)
+        : TimerGroup(baseTick, ThreadOptions(), clock)
+{
+}
+
+TimerGroup::TimerGroup(std::chrono::nanoseconds baseTick, const ThreadOptions& options, IClock& clock)
+        : _clock(clock)
+        , _baseTick(baseTick.count() > 0 ? baseTick : std::chrono::nanoseconds(1))
+        , _epoch(clock.now())
+        , _nextId(0)
+        , _wakeUpCount(0)
+        , _changeCount(0)
+        , _firing(false)
+        , _running(true)
+{
+    // see Timer: all members are initialised before the thread starts
+    _thread = std::make_unique<ConfiguredThread>(options, [this] { run(); });
+}
+
+TimerGroup::~TimerGroup()
+{
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        _running = false;
+    }
+    _cv.notify_all();
+    _thread->join();
+}
+
+int TimerGroup::add(std::chrono::nanoseconds interval, TimerCallback callback, std::chrono::nanoseconds slack)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    auto member = std::make_unique<Member>();
+    member->id = _nextId++;
+    member->interval = interval.count() > 0 ? interval : _baseTick;
+    member->slack = slack;
+    member->callback = std::move(callback);
+    member->deadline = nextDeadline(*member, _clock.now());
+    member->removed = false;
+    _members.push_back(std::move(member));
+    _changeCount++;
+    lock.unlock();
+    _cv.notify_all();
+    return _nextId - 1;
+}
+
+bool TimerGroup::remove(int id)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    auto member = std::find_if(_members.begin(), _members.end(), [id](const std::unique_ptr<Member>& member) { return member->id == id; });
+    if (member == _members.end()) {
+        return false;
+    }
+    if (_firing && std::this_thread::get_id() != _threadId) {
+        _cv.wait(lock, [this] { return !_firing; });
+        member = std::find_if(_members.begin(), _members.end(), [id](const std::unique_ptr<Member>& member) { return member->id == id; });
+        if (member == _members.end()) {
+            return false;
+        }
+    }
+    if (_firing) {
+        // called by a callback, the thread erases it after the callbacks returned
+        (*member)->removed = true;
+    } else {
+        _members.erase(member);
+    }
+    return true;
+}
+
+std::chrono::nanoseconds TimerGroup::getBaseTick() const
+{
+    return _baseTick;
+}
+
+uint64_t TimerGroup::getWakeUpCount()
+{
+    std::lock_guard<std::mutex> lockGuard(_mtx);
+    return _wakeUpCount;
+}
+
+/**
+ * The first multiple of the interval of the member since the epoch, which lies after the given time.
+ */
+IClock::time_point TimerGroup::nextDeadline(const Member& member, IClock::time_point now) const
+{
+    int64_t passed = now > _epoch ? (now - _epoch) / member.interval : 0;
+    return _epoch + member.interval * (passed + 1);
+}
+
+/**
+ * The deadline of the member, postponed to the next base tick, if that is within its slack.
+ */
+IClock::time_point TimerGroup::fireTime(const Member& member) const
+{
+    int64_t ticks = (member.deadline - _epoch + _baseTick - std::chrono::nanoseconds(1)) / _baseTick;
+    IClock::time_point baseTick = _epoch + _baseTick * ticks;
+    return baseTick - member.deadline <= member.slack ? baseTick : member.deadline;
+}
+
+void TimerGroup::run()
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    _threadId = std::this_thread::get_id();
+    std::vector<Member*> due;
+    while (_running) {
+        if (_members.empty()) {
+            _cv.wait(lock, [this] { return !_running || !_members.empty(); });
+            continue;
+        }
+
+        IClock::time_point wakeUp = IClock::time_point::max();
+        for (const auto& member : _members) {
+            wakeUp = std::min(wakeUp, fireTime(*member));
+        }
+        uint64_t changeCount = _changeCount;
+        if (_clock.waitUntil(lock, _cv, wakeUp, [this, changeCount] { return !_running || _changeCount != changeCount; })) {
+            continue;
+        }
+
+        // everything due until now fires with this wake-up, not only the members of the wake-up time
+        IClock::time_point now = _clock.now();
+        due.clear();
+        for (const auto& member : _members) {
+            if (member->deadline <= now) {
+                due.push_back(member.get());
+            }
+        }
+        _wakeUpCount++;
+        _firing = true;
+        lock.unlock();
+        for (Member* member : due) {
+            // an earlier callback of this wake-up may have removed it
+            if (!member->removed) {
+                member->callback();
+            }
+        }
+        lock.lock();
+        _firing = false;
+
+        now = _clock.now();
+        for (Member* member : due) {
+            member->deadline = nextDeadline(*member, now);
+        }
+        _members.erase(std::remove_if(_members.begin(), _members.end(), [](const std::unique_ptr<Member>& member) { return member->removed.load(); }),
+                _members.end());
+        _cv.notify_all();
+    }
+}
+
+} /* namespace essentials */
@@ -0,0 +1,305 @@
+#include "essentials/TimerService.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace essentials
+{
+
+TimerEntry::TimerEntry(InplaceFunction<void()> callback)
+        : _callback(std::move(callback))
+        , _expiryTick(0)
+        , _level(-1)
+        , _active(false)
+        , _firing(false)
+        , _rescheduled(false)
+{
+}
+
+TimerService::TimerService(std::chrono::nanoseconds resolution, IClock& clock)
+        : TimerService(resolution, ThreadOptions(), clock)
+{
+}
+
+TimerService::TimerService(std::chrono::nanoseconds resolution, const ThreadOptions& options, IClock& clock)
+        : _clock(clock)
+        , _resolution(resolution.count() > 0 ? resolution : std::chrono::nanoseconds(1))
+        , _epoch(clock.now())
+        , _currentTick(0)
+        , _nextWakeUpTick(std::numeric_limits<uint64_t>::max())
+        , _scheduledCount(0)
+        , _running(true)
+{
+    std::fill(std::begin(_levelCounts), std::end(_levelCounts), 0);
+    // see Timer: all members are initialised before the thread starts
+    _serviceThread = std::make_unique<ConfiguredThread>(options, [this] { run(); });
+}
+
+TimerService::~TimerService()
+{
+    {
+        std::lock_guard<std::mutex> lockGuard(_mtx);
+        _running = false;
+    }
+    _cv.notify_all();
+    _serviceThread->join();
+}
+
+std::chrono::nanoseconds TimerService::getResolution() const
+{
+    return _resolution;
+}
+
+IClock& TimerService::getClock() const
+{
+    return _clock;
+}
+
+void TimerService::schedule(TimerEntry* entry, std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, SchedulingMode mode, OverrunPolicy policy)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    auto now = _clock.now();
+    if (entry->_active && !entry->_firing) {
+        detach(entry);
+        --_scheduledCount;
+    }
+    if (_scheduledCount == 0 && isEmpty(_expired)) {
+        // nothing needs to be caught up with, so skip the ticks passed while idle
+        _currentTick = std::max(_currentTick, toTick(now));
+    }
+    entry->_schedule.configure(interval, mode, policy);
+    entry->_schedule.start(now + delay);
+    entry->_active = true;
+    if (entry->_firing) {
+        // the service thread reinserts it after the callback returned
+        entry->_rescheduled = true;
+        return;
+    }
+    insert(entry);
+    if (entry->_expiryTick < _nextWakeUpTick) {
+        _nextWakeUpTick = entry->_expiryTick;
+        lock.unlock();
+        _cv.notify_all();
+    }
+}
+
+void TimerService::cancel(TimerEntry* entry, bool waitForCallback)
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    if (entry->_active && !entry->_firing) {
+        detach(entry);
+        --_scheduledCount;
+    }
+    entry->_active = false;
+    entry->_rescheduled = false;
+    if (waitForCallback && std::this_thread::get_id() != _serviceThreadId) {
+        _firingDoneCV.wait(lock, [entry] { return !entry->_firing; });
+    }
+}
+
+uint64_t TimerService::toTick(IClock::time_point timePoint) const
+{
+    if (timePoint <= _epoch) {
+        return 0;
+    }
+    return static_cast<uint64_t>((timePoint - _epoch) / _resolution);
+}
+
+IClock::time_point TimerService::toTimePoint(uint64_t tick) const
+{
+    return _epoch + _resolution * static_cast<int64_t>(tick);
+}
+
+void TimerService::run()
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    _serviceThreadId = std::this_thread::get_id();
+    while (_running) {
+        if (_scheduledCount == 0) {
+            _nextWakeUpTick = std::numeric_limits<uint64_t>::max();
+            _cv.wait(lock, [this] { return !_running || _scheduledCount > 0; });
+            continue;
+        }
+
+        uint64_t wakeUpTick = nextWakeUpTick();
+        _nextWakeUpTick = wakeUpTick;
+        auto wakeUp = toTimePoint(wakeUpTick);
+        if (_clock.now() < wakeUp) {
+            // schedule lowers the wake-up tick for earlier timers
+            _clock.waitUntil(lock, _cv, wakeUp, [this, wakeUpTick] { return !_running || _nextWakeUpTick != wakeUpTick; });
+            continue;
+        }
+
+        // process every tick up to now, which has due timers or cascades
+        uint64_t nowTick = toTick(_clock.now());
+        while (_running && _currentTick < nowTick) {
+            processTick(std::min(nextWakeUpTick(), nowTick));
+        }
+    }
+}
+
+/**
+ * Determines the next tick, which has due timers or cascades a non-empty slot.
+ * The ticks of each level are scanned up to the end of its current revolution,
+ * levels without any entries are skipped. All ticks before the returned one
+ * can be passed without processing them.
+ */
+uint64_t TimerService::nextWakeUpTick() const
+{
+    uint64_t revolutionEnd = _currentTick + 1;
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = SLOT_BITS * level;
+        revolutionEnd = ((_currentTick >> (shift + SLOT_BITS)) + 1) << (shift + SLOT_BITS);
+        if (_levelCounts[level] == 0) {
+            continue;
+        }
+        for (uint64_t tick = ((_currentTick >> shift) + 1) << shift; tick < revolutionEnd; tick += uint64_t(1) << shift) {
+            if (!isEmpty(_wheel[level][(tick >> shift) & SLOT_MASK])) {
+                return tick;
+            }
+        }
+        // the entries of this level belong to the next revolution
+        return revolutionEnd;
+    }
+    return revolutionEnd;
+}
+
+void TimerService::processTick(uint64_t tick)
+{
+    _currentTick = tick;
+    for (int level = LEVELS - 1; level > 0; --level) {
+        if ((tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+            cascade(level, tick);
+        }
+    }
+
+    // move the due entries to the expired list, so that cancel can still remove them
+    TimerLink& slot = _wheel[0][tick & SLOT_MASK];
+    TimerLink pending;
+    while (!isEmpty(slot)) {
+        TimerEntry* entry = static_cast<TimerEntry*>(slot.next);
+        detach(entry);
+        link(&pending, entry);
+    }
+    while (!isEmpty(pending)) {
+        TimerEntry* entry = static_cast<TimerEntry*>(pending.next);
+        unlink(entry);
+        if (entry->_expiryTick > tick) {
+            // the deadline is beyond the range of the wheel, so it waits for another round
+            --_scheduledCount;
+            insert(entry);
+        } else {
+            link(&_expired, entry);
+        }
+    }
+
+    while (!isEmpty(_expired)) {
+        TimerEntry* entry = static_cast<TimerEntry*>(_expired.next);
+        unlink(entry);
+        --_scheduledCount;
+        entry->_firing = true;
+        _mtx.unlock();
+        entry->_callback();
+        _mtx.lock();
+        entry->_firing = false;
+        if (entry->_rescheduled) {
+            entry->_rescheduled = false;
+            insert(entry);
+        } else if (entry->_active) {
+            if (entry->_schedule.getInterval().count() > 0) {
+                entry->_schedule.advance(_clock.now());
+                insert(entry);
+            } else {
+                entry->_active = false;
+            }
+        }
+        _firingDoneCV.notify_all();
+    }
+}
+
+/**
+ * Links the entry into the slot of its deadline. The level is chosen by the
+ * distance to the current tick, so that each level covers SLOTS times the
+ * range of the level below.
+ */
+void TimerService::insert(TimerEntry* entry)
+{
+    auto deadline = entry->_schedule.getDeadline();
+    uint64_t expiryTick = toTick(deadline);
+    if (toTimePoint(expiryTick) < deadline) {
+        ++expiryTick;
+    }
+    expiryTick = std::max(expiryTick, _currentTick + 1);
+    entry->_expiryTick = expiryTick;
+    // deadlines beyond the range of the wheel are parked in its last slot and inserted again from there
+    uint64_t maxDelta = (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    uint64_t slotTick = std::min(expiryTick, _currentTick + maxDelta);
+
+    uint64_t delta = slotTick - _currentTick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    link(&_wheel[level][(slotTick >> (SLOT_BITS * level)) & SLOT_MASK], entry);
+    entry->_level = level;
+    ++_levelCounts[level];
+    ++_scheduledCount;
+}
+
+/**
+ * Unlinks the entry from the wheel or the expired list.
+ */
+void TimerService::detach(TimerEntry* entry)
+{
+    unlink(entry);
+    if (entry->_level >= 0) {
+        --_levelCounts[entry->_level];
+        entry->_level = -1;
+    }
+}
+
+/**
+ * Redistributes the entries of the slot of the given level, which is due
+ * with the given tick, to the levels below.
+ */
+void TimerService::cascade(int level, uint64_t tick)
+{
+    TimerLink& slot = _wheel[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK];
+    TimerLink pending;
+    while (!isEmpty(slot)) {
+        TimerEntry* entry = static_cast<TimerEntry*>(slot.next);
+        detach(entry);
+        link(&pending, entry);
+        --_scheduledCount;
+    }
+    while (!isEmpty(pending)) {
+        TimerEntry* entry = static_cast<TimerEntry*>(pending.next);
+        unlink(entry);
+        if (entry->_expiryTick <= tick) {
+            // due with this very tick, inserting it would postpone it to the next one
+            link(&_expired, entry);
+            ++_scheduledCount;
+        } else {
+            insert(entry);
+        }
+    }
+}
+
+void TimerService::link(TimerLink* head, TimerLink* link)
+{
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+void TimerService::unlink(TimerLink* link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->prev = link;
+    link->next = link;
+}
+
+} /* namespace essentials */
@@ -0,0 +1,117 @@
+#include "essentials/WorkStealingThreadPool.h"
+
+#include <algorithm>
+
+namespace essentials
+{
+
+namespace
+{
+// the pool and the worker index of the current thread, if it is a worker
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local unsigned int currentWorker = 0;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int threadCount)
+        : _nextWorker(0)
+        , _pendingTasks(0)
+        , _idleWorkers(0)
+        , _running(true)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // all queues exist before the first worker starts stealing
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _workers[i]->thread = std::thread(&WorkStealingThreadPool::run, this, i);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lockGuard(_idleMtx);
+        _running = false;
+    }
+    _idleCV.notify_all();
+    for (auto& worker : _workers) {
+        worker->thread.join();
+    }
+}
+
+unsigned int WorkStealingThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(_workers.size());
+}
+
+void WorkStealingThreadPool::execute(std::function<void()> task)
+{
+    unsigned int index = currentPool == this ? currentWorker : _nextWorker++ % _workers.size();
+    // counted before it is visible, so that a worker taking it right away cannot make the count wrap
+    _pendingTasks++;
+    {
+        std::lock_guard<std::mutex> lockGuard(_workers[index]->mtx);
+        _workers[index]->tasks.push_back(std::move(task));
+    }
+    if (_idleWorkers > 0) {
+        {
+            // taking the lock avoids a lost wake-up of a worker that is about to sleep
+            std::lock_guard<std::mutex> lockGuard(_idleMtx);
+        }
+        _idleCV.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::run(unsigned int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    std::function<void()> task;
+    while (true) {
+        if (popOwn(index, task) || steal(index, task)) {
+            _pendingTasks--;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_idleMtx);
+        if (!_running && _pendingTasks == 0) {
+            return;
+        }
+        _idleWorkers++;
+        _idleCV.wait(lock, [this] { return !_running || _pendingTasks > 0; });
+        _idleWorkers--;
+    }
+}
+
+bool WorkStealingThreadPool::popOwn(unsigned int index, std::function<void()>& task)
+{
+    Worker& worker = *_workers[index];
+    std::lock_guard<std::mutex> lockGuard(worker.mtx);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingThreadPool::steal(unsigned int thiefIndex, std::function<void()>& task)
+{
+    for (size_t i = 1; i < _workers.size(); i++) {
+        Worker& victim = *_workers[(thiefIndex + i) % _workers.size()];
+        std::lock_guard<std::mutex> lockGuard(victim.mtx);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} /* namespace essentials */
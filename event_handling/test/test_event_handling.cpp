@@ -1,8 +1,31 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <string>
+#include <system_error>
 #include <thread>
 
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <essentials/AggregatingTrigger.h>
+#include <essentials/BroadcastEvent.h>
+#include <essentials/Clock.h>
+#include <essentials/Coroutine.h>
+#include <essentials/EventChannel.h>
+#include <essentials/EventLoop.h>
+#include <essentials/EventTrigger.h>
+#include <essentials/FutexTrigger.h>
+#include <essentials/IExecutor.h>
+#include <essentials/LatencyHistogram.h>
 #include <essentials/NotifyTimer.hpp>
+#include <essentials/PeriodicSchedule.h>
+#include <essentials/Timer.h>
+#include <essentials/TimerGroup.h>
+#include <essentials/WaitPolicy.h>
+#include <essentials/TimerService.h>
+#include <essentials/WorkStealingThreadPool.h>
 
 class EventTest : public ::testing::Test
 {
@@ -39,6 +62,868 @@ TEST_F(EventTest, timerEvent)
     EXPECT_EQ(3, callbackInt) << "WRONG value of times!" << std::endl;
 }
 
+TEST(PeriodicSchedule, fixedRateDoesNotDrift)
+{
+    using namespace std::chrono;
+    essentials::PeriodicSchedule schedule(milliseconds(10));
+    auto start = essentials::PeriodicSchedule::Clock::now();
+    schedule.start(start);
+    for (int i = 1; i <= 100; i++) {
+        // each callback returns 3 ms late
+        EXPECT_EQ(0u, schedule.advance(schedule.getDeadline() + milliseconds(3)));
+    }
+    EXPECT_EQ(start + milliseconds(1000), schedule.getDeadline());
+}
+
+TEST(PeriodicSchedule, overrunPolicies)
+{
+    using namespace std::chrono;
+    auto start = essentials::PeriodicSchedule::Clock::now();
+    // the first callback returns after 35 ms, so the ticks at 10, 20 and 30 ms are missed
+    auto callbackEnd = start + milliseconds(35);
+
+    essentials::PeriodicSchedule skip(milliseconds(10), essentials::SchedulingMode::FIXED_RATE, essentials::OverrunPolicy::SKIP);
+    skip.start(start);
+    EXPECT_EQ(3u, skip.advance(callbackEnd));
+    EXPECT_EQ(start + milliseconds(40), skip.getDeadline());
+
+    essentials::PeriodicSchedule catchUp(milliseconds(10), essentials::SchedulingMode::FIXED_RATE, essentials::OverrunPolicy::CATCH_UP);
+    catchUp.start(start);
+    EXPECT_EQ(3u, catchUp.advance(callbackEnd));
+    EXPECT_EQ(start + milliseconds(10), catchUp.getDeadline());
+    EXPECT_EQ(0u, catchUp.advance(callbackEnd));
+    EXPECT_EQ(start + milliseconds(20), catchUp.getDeadline());
+    EXPECT_EQ(3u, catchUp.getMissedTicks());
+
+    essentials::PeriodicSchedule coalesce(milliseconds(10), essentials::SchedulingMode::FIXED_RATE, essentials::OverrunPolicy::COALESCE);
+    coalesce.start(start);
+    EXPECT_EQ(3u, coalesce.advance(callbackEnd));
+    EXPECT_EQ(start + milliseconds(30), coalesce.getDeadline());
+    EXPECT_EQ(0u, coalesce.advance(callbackEnd));
+    EXPECT_EQ(start + milliseconds(40), coalesce.getDeadline());
+
+    essentials::PeriodicSchedule fixedDelay(milliseconds(10), essentials::SchedulingMode::FIXED_DELAY);
+    fixedDelay.start(start);
+    EXPECT_EQ(0u, fixedDelay.advance(callbackEnd));
+    EXPECT_EQ(callbackEnd + milliseconds(10), fixedDelay.getDeadline());
+}
+
+/**
+ * Waits in real time until the counter reached the expected value, which happens
+ * right after advancing a manual clock, as soon as the timer thread got to run.
+ */
+bool waitForTicks(const std::atomic<int>& ticks, int expected)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ticks.load() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    return ticks.load() == expected;
+}
+
+/**
+ * Waits in real time until the given number of threads wait for the manual clock,
+ * i.e., until the timer threads processed the last step of the clock.
+ */
+bool waitForWaiters(essentials::ManualClock& clock, size_t expected = 1)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (clock.getWaiterCount() != expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    return clock.getWaiterCount() == expected;
+}
+
+class TickCounter
+{
+public:
+    std::atomic<int> ticks{0};
+    void tick() { ticks++; }
+};
+
+TEST(TimerService, drivesManyTimersFromOneThread)
+{
+    essentials::ManualClock clock;
+    essentials::TimerService service(std::chrono::milliseconds(1), clock);
+    std::vector<TickCounter> counters(20);
+    std::vector<std::unique_ptr<essentials::NotifyTimer<TickCounter>>> timers;
+    for (auto& counter : counters) {
+        timers.push_back(std::make_unique<essentials::NotifyTimer<TickCounter>>(
+                std::chrono::milliseconds(10), std::chrono::milliseconds(10), &TickCounter::tick, &counter, service));
+        timers.back()->start();
+    }
+
+    for (int i = 1; i <= 10; i++) {
+        clock.advance(std::chrono::milliseconds(10));
+        for (auto& counter : counters) {
+            ASSERT_TRUE(waitForTicks(counter.ticks, i));
+        }
+        ASSERT_TRUE(waitForWaiters(clock));
+    }
+    for (auto& timer : timers) {
+        timer->stop();
+    }
+    clock.advance(std::chrono::milliseconds(50));
+    ASSERT_TRUE(waitForWaiters(clock, 0));
+
+    for (auto& counter : counters) {
+        EXPECT_EQ(10, counter.ticks) << "Timer ticked after stop!";
+    }
+}
+
+TEST(WorkStealingThreadPool, executesNestedTasks)
+{
+    std::atomic<int> executed{0};
+    {
+        essentials::WorkStealingThreadPool pool(4);
+        for (int i = 0; i < 100; i++) {
+            pool.execute([&] {
+                for (int j = 0; j < 10; j++) {
+                    pool.execute([&] { executed++; });
+                }
+                executed++;
+            });
+        }
+    }
+    EXPECT_EQ(1100, executed);
+}
+
+class SlowCallback
+{
+public:
+    std::atomic<int> calls{0};
+    std::atomic<bool> released{false};
+    void block()
+    {
+        calls++;
+        while (!released) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+TEST(WorkStealingThreadPool, slowCallbacksDoNotDelayOtherTimers)
+{
+    essentials::WorkStealingThreadPool pool(2);
+    SlowCallback slow;
+    TickCounter counter;
+    {
+        essentials::ManualClock clock;
+        essentials::TimerService service(std::chrono::milliseconds(1), clock);
+        essentials::NotifyTimer<SlowCallback> slowTimer(
+                std::chrono::milliseconds(10), std::chrono::milliseconds(10), &SlowCallback::block, &slow, service);
+        essentials::NotifyTimer<TickCounter> fastTimer(std::chrono::milliseconds(10), std::chrono::milliseconds(10), &TickCounter::tick, &counter, service);
+        slowTimer.setExecutor(&pool);
+        slowTimer.start();
+        fastTimer.start();
+        // the first slow callback blocks a worker of the pool for the whole test
+        for (int i = 1; i <= 10; i++) {
+            clock.advance(std::chrono::milliseconds(10));
+            ASSERT_TRUE(waitForTicks(counter.ticks, i));
+            ASSERT_TRUE(waitForWaiters(clock));
+        }
+        fastTimer.stop();
+        slowTimer.stop();
+        EXPECT_EQ(9u, slowTimer.getMissedTicks());
+        slow.released = true;
+    }
+    EXPECT_EQ(10, counter.ticks);
+    EXPECT_EQ(1, slow.calls);
+}
+
+TEST(EventTrigger, callbacksMayRegisterCallbacks)
+{
+    essentials::EventTrigger trigger;
+    std::atomic<int> calls{0};
+    trigger.registerCallback([&] {
+        if (calls++ == 0) {
+            // deadlocked, while run held the lock of the callbacks
+            trigger.registerCallback([&calls] { calls++; });
+        }
+    });
+    trigger.run(true);
+    EXPECT_EQ(1, calls);
+    trigger.run(true);
+    EXPECT_EQ(3, calls);
+}
+
+TEST(EventTrigger, waitForNotifyPicksUpFiresWhileParking)
+{
+    const int rounds = 2000;
+    essentials::EventTrigger trigger;
+    // parks right away, so that many fires hit the consumer between checking the flag and blocking
+    essentials::AdaptiveWaitPolicy policy(0, 0, 0);
+    std::condition_variable cv;
+    std::mutex mtx;
+    trigger.registerCV(&cv);
+    std::atomic<int> parking{0};
+    std::atomic<int> consumed{0};
+    std::thread consumer([&] {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (int i = 1; i <= rounds; i++) {
+            parking = i;
+            trigger.waitForNotify(&cv, lock, policy);
+            trigger.setNotifyCalled(&cv, false);
+            consumed = i;
+        }
+    });
+    bool missed = false;
+    for (int i = 1; i <= rounds && !missed; i++) {
+        while (parking < i) {
+            std::this_thread::yield();
+        }
+        trigger.run(false);
+        missed = !waitForTicks(consumed, i);
+    }
+    // releases a consumer that missed a fire
+    while (consumed < rounds) {
+        trigger.run(false);
+        std::this_thread::yield();
+    }
+    consumer.join();
+    EXPECT_FALSE(missed);
+}
+
+TEST(EventTrigger, handsCallbacksToExecutor)
+{
+    essentials::WorkStealingThreadPool pool(2);
+    essentials::EventTrigger trigger;
+    std::atomic<int> calls{0};
+    std::thread::id callerId = std::this_thread::get_id();
+    std::atomic<bool> calledOnCaller{false};
+    trigger.registerCallback([&] {
+        calledOnCaller = calledOnCaller || std::this_thread::get_id() == callerId;
+        calls++;
+    });
+    trigger.setExecutor(&pool);
+    trigger.run(true);
+    trigger.run(true);
+    while (calls < 2) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(calledOnCaller);
+}
+
+TEST(FutexTrigger, wakesWaitingThreads)
+{
+    essentials::FutexTrigger trigger;
+    EXPECT_FALSE(trigger.waitFor(std::chrono::milliseconds(1)));
+
+    std::atomic<int> woken{0};
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; i++) {
+        waiters.emplace_back([&] {
+            trigger.wait();
+            woken++;
+        });
+    }
+    trigger.run(true);
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+
+    EXPECT_EQ(4, woken);
+    EXPECT_TRUE(trigger.tryConsume());
+    EXPECT_FALSE(trigger.isNotifyCalled());
+
+    // the largest timeouts must not overflow into a deadline in the past
+    essentials::AdaptiveWaitPolicy policy;
+    for (int i = 0; i < 2; i++) {
+        std::thread firing([&trigger] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            trigger.run(false);
+        });
+        EXPECT_TRUE(i == 0 ? trigger.waitFor(std::chrono::nanoseconds::max()) : trigger.waitFor(std::chrono::nanoseconds::max(), policy));
+        EXPECT_TRUE(trigger.tryConsume());
+        firing.join();
+    }
+}
+
+TEST(BroadcastEvent, wakesAllWaitersOfAGeneration)
+{
+    essentials::EventTrigger trigger;
+    essentials::BroadcastEvent& event = trigger.getBroadcastEvent();
+    uint32_t seen = event.getGeneration();
+    EXPECT_FALSE(event.waitFor(seen, std::chrono::milliseconds(1)));
+
+    std::atomic<int> woken{0};
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 100; i++) {
+        waiters.emplace_back([&, seen] {
+            EXPECT_NE(seen, event.wait(seen));
+            woken++;
+        });
+    }
+    trigger.run(true);
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+
+    EXPECT_EQ(100, woken);
+    EXPECT_TRUE(event.hasFiredSince(seen));
+    EXPECT_FALSE(event.hasFiredSince(event.getGeneration()));
+
+    // the largest timeouts must not overflow into a deadline in the past
+    essentials::AdaptiveWaitPolicy policy;
+    for (int i = 0; i < 2; i++) {
+        uint32_t generation = event.getGeneration();
+        std::thread firing([&event] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            event.run();
+        });
+        EXPECT_TRUE(i == 0 ? event.waitFor(generation, std::chrono::nanoseconds::max())
+                           : event.waitFor(generation, std::chrono::nanoseconds::max(), policy));
+        EXPECT_EQ(event.getGeneration(), generation);
+        firing.join();
+    }
+}
+
+TEST(LatencyHistogram, percentilesAreWithinBucketPrecision)
+{
+    essentials::LatencyHistogram histogram;
+    for (int i = 1; i <= 1000; i++) {
+        histogram.record(std::chrono::microseconds(i));
+    }
+
+    essentials::HistogramSnapshot snapshot = histogram.snapshot(true);
+    EXPECT_EQ(1000u, snapshot.count);
+    EXPECT_EQ(1000000u, snapshot.max);
+    EXPECT_NEAR(500000.0, static_cast<double>(snapshot.getPercentile(50)), 500000.0 / essentials::LatencyHistogram::SUB_BUCKETS);
+    EXPECT_NEAR(990000.0, static_cast<double>(snapshot.getPercentile(99)), 990000.0 / essentials::LatencyHistogram::SUB_BUCKETS);
+    EXPECT_EQ(0u, histogram.snapshot().count);
+}
+
+TEST(LatencyHistogram, timerRecordsLatenessAndCallbackDuration)
+{
+    TickCounter counter;
+    essentials::NotifyTimer<TickCounter> timer(std::chrono::milliseconds(5), std::chrono::milliseconds(0), &TickCounter::tick, &counter);
+    EXPECT_EQ(nullptr, timer.getStatistics());
+    timer.enableStatistics();
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    timer.stop();
+
+    essentials::HistogramSnapshot lateness = timer.getStatistics()->lateness.snapshot();
+    EXPECT_GE(lateness.count, 5u);
+    // the last callback might still be running
+    EXPECT_GE(timer.getStatistics()->callbackDuration.snapshot().count + 1, lateness.count);
+}
+
+TEST(Timer, callsLambdaWithCapturedState)
+{
+    std::atomic<int> ticks(0);
+    std::string name = "timer";
+    essentials::Timer timer(std::chrono::milliseconds(5), std::chrono::milliseconds(0), [&ticks, name] {
+        if (name == "timer") {
+            ticks++;
+        }
+    });
+    EXPECT_FALSE(timer.isStarted());
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    timer.stop();
+    EXPECT_GE(ticks.load(), 5);
+
+    essentials::InplaceFunction<int(int)> moved([](int value) { return value * 2; });
+    essentials::InplaceFunction<int(int)> function(std::move(moved));
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(42, function(21));
+}
+
+TEST(Timer, runsSubMillisecondIntervals)
+{
+    essentials::ManualClock clock;
+    std::atomic<int> ticks(0);
+    essentials::Timer timer(std::chrono::microseconds(250), std::chrono::microseconds(250), [&ticks] { ticks++; }, clock);
+    timer.setSpinThreshold(std::chrono::microseconds(50));
+    EXPECT_EQ(250, timer.getInterval<std::chrono::microseconds>().count());
+    EXPECT_EQ(0, timer.getInterval().count());
+    timer.start();
+    ASSERT_TRUE(waitForWaiters(clock));
+    // 4 kHz for 100 ms
+    for (int i = 1; i <= 400; i++) {
+        clock.advance(std::chrono::microseconds(250));
+        ASSERT_TRUE(waitForTicks(ticks, i));
+        ASSERT_TRUE(waitForWaiters(clock));
+    }
+    timer.stop();
+    EXPECT_EQ(400, ticks.load());
+    EXPECT_EQ(0u, timer.getMissedTicks());
+}
+
+TEST(AggregatingTrigger, foldsBurstsIntoSingleNotifications)
+{
+    essentials::TimerService service(std::chrono::microseconds(100));
+    std::condition_variable cv;
+
+    essentials::DebounceTrigger debounce(std::chrono::milliseconds(20), service);
+    debounce.registerCV(&cv);
+    for (int i = 0; i < 100; i++) {
+        debounce.run(false);
+    }
+    EXPECT_EQ(0u, debounce.getDeliveryCount());
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_TRUE(debounce.isNotifyCalled(&cv));
+    EXPECT_EQ(1u, debounce.getDeliveryCount());
+    EXPECT_EQ(99u, debounce.getCoalescedCount());
+    EXPECT_EQ(100u, debounce.takeEventCount());
+    EXPECT_EQ(0u, debounce.takeEventCount());
+
+    essentials::ThrottleTrigger throttle(std::chrono::milliseconds(20), service);
+    for (int i = 0; i < 100; i++) {
+        throttle.run(false);
+    }
+    // the first run is delivered right away, the others at the end of the interval
+    EXPECT_EQ(1u, throttle.getDeliveryCount());
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(2u, throttle.getDeliveryCount());
+    EXPECT_EQ(98u, throttle.getCoalescedCount());
+    EXPECT_EQ(100u, throttle.takeEventCount());
+
+    essentials::CoalescingTrigger coalescing(10, std::chrono::milliseconds(20), service);
+    for (int i = 0; i < 25; i++) {
+        coalescing.run(false);
+    }
+    EXPECT_EQ(2u, coalescing.getDeliveryCount());
+    EXPECT_EQ(20u, coalescing.takeEventCount());
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(3u, coalescing.getDeliveryCount());
+    EXPECT_EQ(5u, coalescing.takeEventCount());
+    EXPECT_EQ(22u, coalescing.getCoalescedCount());
+}
+
+TEST(EventChannel, handsEventsFromSingleProducerInOrder)
+{
+    essentials::EventChannel<int> channel(100);
+    EXPECT_EQ(128u, channel.getCapacity());
+    int item;
+    EXPECT_FALSE(channel.pop(item, std::chrono::milliseconds(1)));
+
+    const int count = 100000;
+    std::thread producer([&channel] {
+        int batch[10];
+        for (int i = 0; i < count; i += 10) {
+            for (int j = 0; j < 10; j++) {
+                batch[j] = i + j;
+            }
+            size_t pushed = 0;
+            while (pushed < 10) {
+                pushed += channel.tryPushBatch(batch + pushed, 10 - pushed);
+            }
+        }
+    });
+    int expected = 0;
+    int batch[16];
+    while (expected < count) {
+        size_t popped = channel.popBatch(batch, 16, std::chrono::seconds(5));
+        ASSERT_GT(popped, 0u);
+        for (size_t i = 0; i < popped; i++) {
+            ASSERT_EQ(expected++, batch[i]);
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(channel.empty());
+}
+
+TEST(EventChannel, collectsEventsOfManyProducers)
+{
+    essentials::EventChannel<std::string, essentials::MpscRing> channel(64);
+    const int producerCount = 4;
+    const int count = 10000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; p++) {
+        producers.emplace_back([&channel, p] {
+            for (int i = 0; i < count; i++) {
+                while (!channel.tryPush(std::to_string(p))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<int> received(producerCount, 0);
+    std::string item;
+    for (int i = 0; i < producerCount * count; i++) {
+        ASSERT_TRUE(channel.pop(item, std::chrono::seconds(5)));
+        received[std::stoi(item)]++;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    for (int receivedCount : received) {
+        EXPECT_EQ(count, receivedCount);
+    }
+    EXPECT_FALSE(channel.tryPop(item));
+}
+
+TEST(ManualClock, stepsTimersInVirtualTime)
+{
+    essentials::ManualClock clock;
+    std::atomic<int> ticks(0);
+    essentials::Timer timer(std::chrono::seconds(1), std::chrono::seconds(1), [&ticks] { ticks++; }, clock);
+    timer.start();
+    clock.advance(std::chrono::milliseconds(999));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(0, ticks.load());
+    for (int i = 1; i <= 100; i++) {
+        clock.advance(i == 1 ? std::chrono::milliseconds(1) : std::chrono::milliseconds(1000));
+        ASSERT_TRUE(waitForTicks(ticks, i));
+    }
+    timer.stop();
+
+    essentials::TimerService service(std::chrono::milliseconds(1), clock);
+    std::atomic<int> serviceTicks(0);
+    essentials::Timer serviceTimer(std::chrono::minutes(1), std::chrono::minutes(1), [&serviceTicks] { serviceTicks++; }, service);
+    serviceTimer.start();
+    for (int i = 1; i <= 60; i++) {
+        clock.advance(std::chrono::minutes(1));
+        ASSERT_TRUE(waitForTicks(serviceTicks, i));
+    }
+    EXPECT_EQ(0u, serviceTimer.getMissedTicks());
+}
+
+TEST(ManualClock, longDelaysBeyondTheWheelDoNotFireEarly)
+{
+    // with a resolution of 1 us, the wheel covers 2^32 us, which is about 71.6 minutes
+    essentials::ManualClock clock;
+    essentials::TimerService service(std::chrono::microseconds(1), clock);
+    std::atomic<int> ticks(0);
+    essentials::IClock::time_point firedAt;
+    essentials::TimerEntry entry([&] {
+        firedAt = clock.now();
+        ticks++;
+    });
+    auto deadline = clock.now() + std::chrono::hours(3);
+    service.schedule(&entry, std::chrono::hours(3), std::chrono::nanoseconds(0));
+
+    for (int minutes = 0; minutes < 179; minutes++) {
+        clock.advance(std::chrono::minutes(1));
+    }
+    clock.advance(std::chrono::seconds(59));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(0, ticks.load());
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_TRUE(waitForTicks(ticks, 1));
+    EXPECT_EQ(deadline, firedAt);
+    service.cancel(&entry);
+}
+
+TEST(ThreadOptions, configuresTimerThreads)
+{
+    essentials::ThreadOptions pinned;
+    pinned.cpus = {0};
+    pinned.stackSize = 1 << 20;
+    std::atomic<int> wrongCpu(0);
+    std::atomic<int> ticks(0);
+    {
+        essentials::Timer timer(std::chrono::milliseconds(1), std::chrono::milliseconds(0), [&] {
+            wrongCpu += sched_getcpu() != 0;
+            ticks++;
+        }, pinned);
+        timer.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_GT(ticks.load(), 0);
+    EXPECT_EQ(0, wrongCpu.load());
+
+    essentials::ThreadOptions tinyStack;
+    tinyStack.stackSize = 1;
+    EXPECT_THROW(essentials::Timer(std::chrono::milliseconds(1), std::chrono::milliseconds(0), [] {}, tinyStack), std::system_error);
+
+    // depends on the permissions of the test, but must not fail silently
+    essentials::ThreadOptions realTime;
+    realTime.scheduling = essentials::ThreadScheduling::FIFO;
+    realTime.priority = 10;
+    realTime.lockStack = true;
+    try {
+        int policy = -1;
+        essentials::TimerService service(std::chrono::milliseconds(1), realTime);
+        essentials::Timer timer(std::chrono::milliseconds(1), std::chrono::milliseconds(0), [&policy] {
+            sched_param param;
+            pthread_getschedparam(pthread_self(), &policy, &param);
+        }, service);
+        timer.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        timer.stop();
+        EXPECT_EQ(SCHED_FIFO, policy);
+    } catch (const std::system_error& error) {
+        EXPECT_TRUE(error.code().value() == EPERM || error.code().value() == ENOMEM || error.code().value() == EAGAIN) << error.what();
+    }
+}
+
+TEST(TimerGroup, firesRelatedTimersInOneWakeUp)
+{
+    essentials::ManualClock clock;
+    essentials::TimerGroup group(std::chrono::milliseconds(10), clock);
+    std::atomic<int> ticks10(0);
+    std::atomic<int> ticks20(0);
+    std::atomic<int> ticks50(0);
+    std::atomic<int> ticks13(0);
+    group.add(std::chrono::milliseconds(10), [&ticks10] { ticks10++; });
+    group.add(std::chrono::milliseconds(20), [&ticks20] { ticks20++; });
+    group.add(std::chrono::milliseconds(50), [&ticks50] { ticks50++; });
+    // merged onto the 10 ms ticks, since the next one is at most 9 ms away
+    int id = group.add(std::chrono::milliseconds(13), [&ticks13] { ticks13++; }, std::chrono::milliseconds(9));
+    ASSERT_TRUE(waitForWaiters(clock));
+
+    int expected13 = 0;
+    int deadline13 = 13;
+    for (int t = 1; t <= 200; t++) {
+        clock.advance(std::chrono::milliseconds(1));
+        if (t % 10 != 0) {
+            continue;
+        }
+        if (deadline13 <= t) {
+            expected13++;
+            deadline13 = (t / 13 + 1) * 13;
+        }
+        ASSERT_TRUE(waitForTicks(ticks10, t / 10));
+        ASSERT_TRUE(waitForTicks(ticks20, t / 20));
+        ASSERT_TRUE(waitForTicks(ticks50, t / 50));
+        ASSERT_TRUE(waitForTicks(ticks13, expected13));
+        ASSERT_TRUE(waitForWaiters(clock));
+    }
+    EXPECT_TRUE(group.remove(id));
+    EXPECT_FALSE(group.remove(id));
+
+    EXPECT_EQ(15, expected13);
+    // without merging, the 13 ms member alone would add 15 wake-ups
+    EXPECT_EQ(20u, group.getWakeUpCount());
+}
+
+TEST(TimerGroup, callbacksMayRemoveMembersOfTheSameWakeUp)
+{
+    essentials::ManualClock clock;
+    essentials::TimerGroup group(std::chrono::milliseconds(10), clock);
+    std::atomic<int> removerTicks(0);
+    std::atomic<int> removedTicks(0);
+    int removedId = -1;
+    group.add(std::chrono::milliseconds(10), [&] {
+        group.remove(removedId);
+        removerTicks++;
+    });
+    removedId = group.add(std::chrono::milliseconds(10), [&removedTicks] { removedTicks++; });
+    ASSERT_TRUE(waitForWaiters(clock));
+
+    // both are due, but the first one removes the second one before it is called
+    clock.advance(std::chrono::milliseconds(10));
+    ASSERT_TRUE(waitForTicks(removerTicks, 1));
+    ASSERT_TRUE(waitForWaiters(clock));
+    clock.advance(std::chrono::milliseconds(10));
+    ASSERT_TRUE(waitForTicks(removerTicks, 2));
+    ASSERT_TRUE(waitForWaiters(clock));
+    EXPECT_EQ(0, removedTicks.load());
+    EXPECT_FALSE(group.remove(removedId));
+}
+
+TEST(AdaptiveWaitPolicy, tunesSpinsToTheWaitingTime)
+{
+    essentials::AdaptiveWaitPolicy policy(16, 1024, 4);
+    // ready right after the spins, so spinning a little longer would have been enough
+    for (int i = 0; i < 10; i++) {
+        uint32_t checks = 0;
+        uint32_t spinLimit = policy.getSpinLimit();
+        EXPECT_TRUE(policy.wait([&checks, spinLimit] { return ++checks > spinLimit + 1; }, [] { return false; }));
+    }
+    EXPECT_EQ(1024u, policy.getSpinLimit());
+    // never ready before parking
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(policy.wait([] { return false; }, [] { return true; }));
+    }
+    EXPECT_EQ(16u, policy.getSpinLimit());
+
+    essentials::FutexTrigger ping;
+    essentials::FutexTrigger pong;
+    std::thread partner([&] {
+        essentials::AdaptiveWaitPolicy partnerPolicy;
+        for (int i = 0; i < 200; i++) {
+            ping.wait(partnerPolicy);
+            ping.tryConsume();
+            pong.run(false);
+        }
+    });
+    essentials::AdaptiveWaitPolicy ownPolicy;
+    for (int i = 0; i < 200; i++) {
+        ping.run(false);
+        ASSERT_TRUE(pong.waitFor(std::chrono::seconds(5), ownPolicy));
+        pong.tryConsume();
+    }
+    partner.join();
+
+    essentials::BroadcastEvent event;
+    uint32_t generation = event.getGeneration();
+    EXPECT_FALSE(event.waitFor(generation, std::chrono::milliseconds(1), ownPolicy));
+    std::thread firing([&event] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        event.run();
+    });
+    EXPECT_EQ(generation + 1, event.wait(generation, ownPolicy));
+    firing.join();
+
+    essentials::EventTrigger trigger;
+    std::condition_variable cv;
+    std::mutex mtx;
+    trigger.registerCV(&cv);
+    trigger.run(false);
+    std::unique_lock<std::mutex> lock(mtx);
+    trigger.waitForNotify(&cv, lock, ownPolicy);
+    EXPECT_TRUE(trigger.isNotifyCalled(&cv));
+}
+
+TEST(EventLoop, servesTimersTriggersAndDescriptorsFromOneThread)
+{
+    std::atomic<int> timerTicks(0);
+    std::atomic<int> triggerCalls(0);
+    std::atomic<int> readBytes(0);
+    essentials::EventTrigger trigger;
+    int pipeFds[2];
+    ASSERT_EQ(0, pipe(pipeFds));
+    {
+        essentials::EventLoop loop;
+        int timerId = loop.addTimer(std::chrono::milliseconds(1), std::chrono::milliseconds(2), [&timerTicks] { timerTicks++; });
+        ASSERT_GE(timerId, 0);
+        int triggerId = loop.addTrigger(trigger, [&triggerCalls] { triggerCalls++; });
+        ASSERT_GE(triggerId, 0);
+        ASSERT_TRUE(loop.watch(pipeFds[0], EPOLLIN, [&readBytes, &pipeFds](uint32_t) {
+            char buffer[16];
+            readBytes += static_cast<int>(read(pipeFds[0], buffer, sizeof(buffer)));
+        }));
+        EXPECT_FALSE(loop.watch(pipeFds[0], EPOLLIN, [](uint32_t) {}));
+
+        trigger.run(false);
+        ASSERT_EQ(3, write(pipeFds[1], "abc", 3));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_TRUE(loop.removeTimer(timerId));
+        EXPECT_FALSE(loop.removeTimer(timerId));
+        int ticks = timerTicks;
+        EXPECT_GE(ticks, 10);
+        EXPECT_EQ(1, triggerCalls.load());
+        EXPECT_EQ(3, readBytes.load());
+
+        EXPECT_TRUE(loop.removeTrigger(triggerId));
+        EXPECT_TRUE(loop.unwatch(pipeFds[0]));
+        trigger.run(false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(ticks, timerTicks.load());
+        EXPECT_EQ(1, triggerCalls.load());
+    }
+    // the loop unregistered its callback from the trigger
+    trigger.run(false);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+}
+
+/**
+ * Counts the callbacks of a trigger instead of executing them.
+ */
+class CountingExecutor : public essentials::IExecutor
+{
+public:
+    void execute(std::function<void()>) override { tasks++; }
+    int tasks = 0;
+};
+
+TEST(EventLoop, removingTriggersUnregistersTheirCallbacks)
+{
+    essentials::EventTrigger trigger;
+    CountingExecutor executor;
+    trigger.setExecutor(&executor);
+    {
+        essentials::EventLoop loop;
+        for (int i = 0; i < 100; ++i) {
+            int triggerId = loop.addTrigger(trigger, [] {});
+            ASSERT_GE(triggerId, 0);
+            EXPECT_TRUE(loop.removeTrigger(triggerId));
+        }
+        trigger.run(false);
+        EXPECT_EQ(0, executor.tasks);
+
+        ASSERT_GE(loop.addTrigger(trigger, [] {}), 0);
+        trigger.run(false);
+        EXPECT_EQ(1, executor.tasks);
+    }
+    trigger.run(false);
+    EXPECT_EQ(1, executor.tasks);
+}
+
+TEST(EventLoop, keepsTheDescriptorOfARunningCallbackOpen)
+{
+    std::atomic<bool> entered{false};
+    std::atomic<bool> released{false};
+    essentials::EventLoop loop;
+    int timerId = loop.addTimer(std::chrono::milliseconds(1), std::chrono::milliseconds(0), [&] {
+        entered = true;
+        while (!released) {
+            std::this_thread::yield();
+        }
+    });
+    ASSERT_GE(timerId, 0);
+    while (!entered) {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(loop.removeTimer(timerId));
+    // closing it now would let the next descriptor reuse the number, while the loop thread still uses it
+    EXPECT_NE(-1, fcntl(timerId, F_GETFD));
+    released = true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (fcntl(timerId, F_GETFD) != -1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(-1, fcntl(timerId, F_GETFD));
+}
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+essentials::CoroutineTask awaitTrigger(essentials::AsyncTrigger& trigger, int& resumed)
+{
+    co_await trigger;
+    resumed++;
+    co_await trigger;
+    resumed++;
+}
+
+essentials::CoroutineTask awaitTicks(essentials::AsyncTimer& timer, int ticks, std::atomic<int>& done)
+{
+    for (int i = 0; i < ticks; i++) {
+        co_await timer.nextTick();
+    }
+    done++;
+}
+
+TEST(Coroutine, resumesWaitersOfTriggersAndTimers)
+{
+    essentials::CoroutineScheduler scheduler;
+    essentials::EventTrigger trigger;
+    essentials::AsyncTrigger asyncTrigger(trigger, scheduler);
+    std::vector<int> resumed(1000, 0);
+    for (int& counter : resumed) {
+        awaitTrigger(asyncTrigger, counter);
+    }
+    trigger.run(false);
+    EXPECT_EQ(1000u, scheduler.runReady());
+    trigger.run(false);
+    EXPECT_EQ(1000u, scheduler.runReady());
+    trigger.run(false);
+    EXPECT_EQ(0u, scheduler.runReady());
+    for (int counter : resumed) {
+        EXPECT_EQ(2, counter);
+    }
+
+    std::atomic<int> done(0);
+    essentials::AsyncTimer timer(std::chrono::milliseconds(2), std::chrono::milliseconds(0), scheduler);
+    awaitTicks(timer, 5, done);
+    awaitTicks(timer, 5, done);
+    std::thread schedulerThread([&scheduler] { scheduler.run(); });
+    timer.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (done < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    timer.stop();
+    scheduler.stop();
+    schedulerThread.join();
+    EXPECT_EQ(2, done.load());
+}
+#endif
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * Keeps the files of a directory tree in memory, so that repeated lookups do not walk the
+ * tree again. The index is built once and kept up to date by a background thread, which
+ * applies the inotify events of every directory in the tree. If the kernel drops events,
+ * the index is rebuilt from disk.
+ *
+ * The results are the same as the ones of FileSystem::findFile and FileSystem::findAllFiles,
+ * except that symlinks to directories are not followed, because they cannot be watched
+ * reliably. If the tree cannot be watched, e.g., because the inotify watch limit is reached,
+ * the queries fall back to walking the tree.
+ */
+class DirectoryIndex
+{
+public:
+    explicit DirectoryIndex(const std::string& root);
+    ~DirectoryIndex();
+    DirectoryIndex(const DirectoryIndex&) = delete;
+    DirectoryIndex& operator=(const DirectoryIndex&) = delete;
+
+    /**
+     * Finds the same file as FileSystem::findFile, if called with the root of the index.
+     */
+    bool findFile(const std::string& file, std::string& path_found) const;
+    /**
+     * Lists the files of the directory like FileSystem::findAllFiles.
+     * Directories outside of the tree are read from disk.
+     */
+    std::vector<std::string> findAllFiles(const std::string& directory, const std::string& ending) const;
+    /**
+     * @return False, if the queries are answered by walking the tree, because it cannot be watched.
+     */
+    bool isWatching() const;
+    /**
+     * The number of times the index was built from disk, including the initial build.
+     */
+    uint64_t getBuildCount() const;
+
+private:
+    /**
+     * Orders names like the DirectoryWalker does.
+     */
+    struct NameOrder
+    {
+        bool operator()(const std::string& a, const std::string& b) const;
+    };
+    /**
+     * Orders paths component-wise, which is the order of a sorted, depth-first walk.
+     */
+    struct PathOrder
+    {
+        bool operator()(const std::string& a, const std::string& b) const;
+    };
+    struct Directory
+    {
+        int watch;
+        std::set<std::string, NameOrder> files;
+        std::set<std::string, NameOrder> subdirectories;
+    };
+
+    void run(); /** < The method executed by the background thread */
+    bool build();
+    void handleEvents(const char* buffer, size_t length);
+    bool addTree(const std::string& directory);
+    bool addDirectory(const std::string& directory);
+    void removeDirectory(const std::string& directory);
+    void addFile(const std::string& directory, const std::string& name);
+    void removeFile(const std::string& directory, const std::string& name);
+    void disable();
+    static std::string normalise(const std::string& directory);
+    static std::string childPath(const std::string& directory, const std::string& name);
+
+    const std::string _root;
+    int _inotifyFd;
+    int _stopFd; /** < An eventfd, which wakes up the background thread for stopping. */
+    mutable std::shared_timed_mutex _mtx;
+    std::unordered_map<std::string, Directory> _directories;
+    std::unordered_map<int, std::string> _watchedDirectories; /** < Maps each watch to the path of its directory. */
+    std::unordered_map<std::string, std::set<std::string, PathOrder>> _pathsByName;
+    std::atomic<bool> _watching; /** < Only changes while the mutex is locked exclusively. */
+    std::atomic<uint64_t> _buildCount;
+    std::thread _thread;
+};
+
+} // namespace essentials
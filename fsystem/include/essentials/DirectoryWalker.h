@@ -0,0 +1,117 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+namespace essentials
+{
+
+enum class DirectoryEntryType
+{
+    FILE,      /** < A regular file, or a symlink to one. */
+    DIRECTORY, /** < A directory, or a symlink to one. */
+    OTHER      /** < Anything else, e.g., a socket or a broken symlink. */
+};
+
+/**
+ * An entry found by the DirectoryWalker. The path is only valid during the call of the visitor.
+ */
+struct DirectoryEntry
+{
+    const char* name;
+    const std::string& path; /** < The path of the walked directory followed by the name. */
+    DirectoryEntryType type;
+};
+
+enum class WalkAction
+{
+    CONTINUE,
+    SKIP_DIRECTORY, /** < Does not descend into the visited directory. */
+    STOP
+};
+
+/**
+ * Walks directory trees with as few system calls and allocations as possible. Entries
+ * are read relative to the file descriptor of their directory and typed by the d_type of
+ * the directory entry; only entries of unknown type and symlinks, which are followed, need
+ * an fstatat. All paths are built in one buffer, which is reused for every entry.
+ * A symlink to a directory on the current path is visited, but not walked into, since
+ * the kernel's limit of nested symlinks does not apply to the relative descents.
+ */
+class DirectoryWalker
+{
+public:
+    using Visitor = std::function<WalkAction(const DirectoryEntry& entry)>;
+
+    /**
+     * @param sorted Visits the entries of each directory in alphabetical order, like alphasort,
+     * instead of the order of the file system.
+     */
+    explicit DirectoryWalker(bool sorted = true);
+
+    /**
+     * Calls the visitor for every entry of the directory, except "." and "..". The
+     * subdirectories are walked depth-first right after they were visited, if recursive is set.
+     * @return False, if the directory could not be opened.
+     */
+    bool walk(const std::string& directory, const Visitor& visitor, bool recursive = true);
+
+private:
+    /**
+     * @return False, if the visitor asked to stop.
+     */
+    bool walkDirectory(int dirFd, const Visitor& visitor, bool recursive);
+    bool visit(int dirFd, const char* name, DirectoryEntryType type, const Visitor& visitor, bool recursive);
+
+    bool _sorted;
+    std::string _path; /** < The path of the current entry, shared by all levels of the walk. */
+    std::vector<std::pair<dev_t, ino_t>> _ancestors; /** < The device and inode of each directory on the current path. */
+};
+
+struct ParallelWalkOptions
+{
+    unsigned int threadCount = 0; /** < The number of threads reading directories, 0 uses four per hardware thread, but at most 16. */
+    bool stopAtFirstMatch = false;
+    /**
+     * Returns the matches in the order of a sorted, sequential walk. With stopAtFirstMatch, this is
+     * the first match of such a walk. Otherwise, matches are returned in the order they were found.
+     */
+    bool deterministic = true;
+};
+
+/**
+ * Walks a directory tree recursively with a bounded pool of threads, which read different
+ * directories at the same time. This pays off when reading a directory is bound by latency,
+ * e.g., on network file systems or with a cold cache. Each directory is a task, the threads
+ * take the tasks of their own queue depth-first and steal the oldest tasks of other threads,
+ * which are close to the root and therefore tend to be large.
+ */
+class ParallelDirectoryWalker
+{
+public:
+    /**
+     * Decides whether the entry is a match. It is called from several threads at the same time.
+     */
+    using Filter = std::function<bool(const DirectoryEntry& entry)>;
+
+    explicit ParallelDirectoryWalker(const ParallelWalkOptions& options = ParallelWalkOptions());
+
+    /**
+     * Collects the paths of all entries below the directory, which match the filter.
+     * Symlinks to directories are followed, except into cycles, like by the DirectoryWalker.
+     */
+    std::vector<std::string> collect(const std::string& directory, const Filter& filter);
+
+private:
+    struct Walk;
+    struct Node;
+
+    ParallelWalkOptions _options;
+};
+
+
+} // namespace essentials
@@ -15,6 +15,18 @@ public:
     static std::string getSelfExeName();
     static bool findFile(const std::string& path, const std::string& file, std::string& path_found);
     static std::vector<std::string> findAllFiles(std::string path, std::string ending);
+    /**
+     * Like findFile, but reads the subdirectories with several threads at the same time. The
+     * found path is the same as the one of findFile.
+     * @param threadCount The number of threads, 0 chooses one depending on the hardware.
+     */
+    static bool findFileParallel(const std::string& path, const std::string& file, std::string& path_found, unsigned int threadCount = 0);
+    /**
+     * Like findAllFiles, but includes all subdirectories, which are read with several threads
+     * at the same time. The files are returned in the order of a sorted, depth-first walk.
+     * @param threadCount The number of threads, 0 chooses one depending on the hardware.
+     */
+    static std::vector<std::string> findAllFilesRecursive(const std::string& path, const std::string& ending, unsigned int threadCount = 0);
     static bool pathExists(const std::string& filename);
     static bool isPathRooted(const std::string& path);
     static std::string combinePaths(const std::string& path1, const std::string& path2);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace essentials
+{
+
+/**
+ * Tells the kernel how the pages of a MappedFile are going to be accessed.
+ */
+enum class AccessHint
+{
+    NORMAL,
+    SEQUENTIAL, /** < Reads ahead aggressively and drops pages soon after they were read. */
+    RANDOM,     /** < Does not read ahead. */
+    WILL_NEED,  /** < Starts reading the pages right away. */
+    HUGE_PAGES  /** < Backs the mapping by transparent huge pages, if the kernel supports them for files. */
+};
+
+/**
+ * Maps a file read-only into memory, so that it can be parsed in place instead of copying
+ * it into a buffer. The pages are shared with the page cache and other processes mapping
+ * the same file. The mapping is released with the object, it can be moved but not copied.
+ * The content must not be used after the file was truncated by someone else.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    /**
+     * Opens the file, check isOpen for success.
+     */
+    explicit MappedFile(const std::string& path, AccessHint hint = AccessHint::NORMAL);
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps the file and applies the hint to the whole mapping. A file opened before is closed.
+     * @return False, if the file could not be mapped, the reason is printed like by perror.
+     */
+    bool open(const std::string& path, AccessHint hint = AccessHint::NORMAL);
+    void close();
+    bool isOpen() const { return _open; }
+
+    /**
+     * Applies the hint to the given range of the file, the offset is rounded down to a page.
+     * @return False, if the kernel rejected the hint.
+     */
+    bool advise(AccessHint hint, size_t offset = 0, size_t length = SIZE_MAX);
+
+    const uint8_t* bytes() const { return _data; }
+    const char* chars() const { return reinterpret_cast<const char*>(_data); }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const uint8_t* begin() const { return _data; }
+    const uint8_t* end() const { return _data + _size; }
+    /**
+     * Copies the content, for APIs that need a string.
+     */
+    std::string toString() const { return std::string(chars(), _size); }
+#if __cplusplus >= 201703L
+    std::string_view view() const { return std::string_view(chars(), _size); }
+#endif
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+    void* _mapping; /** < The start of the mapping, which is aligned to huge pages for the corresponding hint. */
+    size_t _mappingSize;
+    bool _open;
+};
+
+} // namespace essentials
@@ -0,0 +1,384 @@
+#include "essentials/DirectoryIndex.h"
+#include "essentials/DirectoryWalker.h"
+#include "essentials/FileSystem.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace essentials
+{
+
+namespace
+{
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+bool isSymlink(const std::string& path)
+{
+    struct stat buf;
+    return lstat(path.c_str(), &buf) == 0 && S_ISLNK(buf.st_mode);
+}
+} // namespace
+
+bool DirectoryIndex::NameOrder::operator()(const std::string& a, const std::string& b) const
+{
+    int result = strcoll(a.c_str(), b.c_str());
+    // distinct names may collate equally, but the sets need a strict order
+    return result != 0 ? result < 0 : a < b;
+}
+
+bool DirectoryIndex::PathOrder::operator()(const std::string& a, const std::string& b) const
+{
+    size_t aStart = 0;
+    size_t bStart = 0;
+    while (true) {
+        size_t aEnd = a.find(FileSystem::PATH_SEPARATOR, aStart);
+        size_t bEnd = b.find(FileSystem::PATH_SEPARATOR, bStart);
+        std::string aName = a.substr(aStart, aEnd == std::string::npos ? std::string::npos : aEnd - aStart);
+        std::string bName = b.substr(bStart, bEnd == std::string::npos ? std::string::npos : bEnd - bStart);
+        if (aName != bName) {
+            return NameOrder()(aName, bName);
+        }
+        if (aEnd == std::string::npos || bEnd == std::string::npos) {
+            // the path of a directory comes before its content
+            return aEnd == std::string::npos && bEnd != std::string::npos;
+        }
+        aStart = aEnd + 1;
+        bStart = bEnd + 1;
+    }
+}
+
+DirectoryIndex::DirectoryIndex(const std::string& root)
+        : _root(normalise(root))
+        , _inotifyFd(-1)
+        , _stopFd(eventfd(0, EFD_CLOEXEC))
+        , _watching(false)
+        , _buildCount(0)
+{
+    if (_stopFd < 0) {
+        perror("DirectoryIndex");
+        return;
+    }
+    if (!FileSystem::pathExists(_root)) {
+        std::cerr << "FS: Path '" << root << "' does not exists!" << std::endl;
+        return;
+    }
+    {
+        std::lock_guard<std::shared_timed_mutex> lockGuard(_mtx);
+        _watching = build();
+        if (!_watching) {
+            disable();
+            return;
+        }
+    }
+    _thread = std::thread(&DirectoryIndex::run, this);
+}
+
+DirectoryIndex::~DirectoryIndex()
+{
+    if (_thread.joinable()) {
+        uint64_t stop = 1;
+        if (write(_stopFd, &stop, sizeof(stop)) != sizeof(stop)) {
+            perror("DirectoryIndex");
+        }
+        _thread.join();
+    }
+    if (_inotifyFd >= 0) {
+        close(_inotifyFd);
+    }
+    if (_stopFd >= 0) {
+        close(_stopFd);
+    }
+}
+
+bool DirectoryIndex::findFile(const std::string& file, std::string& path_found) const
+{
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+        if (_watching) {
+            auto paths = _pathsByName.find(file);
+            if (paths == _pathsByName.end() || paths->second.empty()) {
+                return false;
+            }
+            path_found = *paths->second.begin();
+            return true;
+        }
+    }
+    return FileSystem::findFile(_root, file, path_found);
+}
+
+std::vector<std::string> DirectoryIndex::findAllFiles(const std::string& directory, const std::string& ending) const
+{
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+        auto entry = _watching ? _directories.find(normalise(directory)) : _directories.end();
+        if (entry != _directories.end()) {
+            std::vector<std::string> files;
+            for (const std::string& name : entry->second.files) {
+                if (FileSystem::hasSuffix(name, ending)) {
+                    files.push_back(childPath(entry->first, name));
+                }
+            }
+            return files;
+        }
+    }
+    // not part of the index, e.g., below a symlink
+    return FileSystem::findAllFiles(directory, ending);
+}
+
+bool DirectoryIndex::isWatching() const
+{
+    return _watching;
+}
+
+uint64_t DirectoryIndex::getBuildCount() const
+{
+    return _buildCount;
+}
+
+void DirectoryIndex::run()
+{
+    // inotify events are aligned like their struct
+    alignas(struct inotify_event) char buffer[4096];
+    struct pollfd fds[2];
+    fds[1].fd = _stopFd;
+    fds[1].events = POLLIN;
+    while (true) {
+        // rebuilding replaces the inotify descriptor, disabling closes it
+        fds[0].fd = _inotifyFd;
+        fds[0].events = POLLIN;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("DirectoryIndex::run");
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            continue;
+        }
+        handleEvents(buffer, static_cast<size_t>(length));
+    }
+}
+
+/**
+ * Drops the index and builds it again from disk, with a new inotify instance, so
+ * that no events of the old watches are left. Needs the exclusive lock.
+ * @return False, if the tree cannot be watched.
+ */
+bool DirectoryIndex::build()
+{
+    _directories.clear();
+    _watchedDirectories.clear();
+    _pathsByName.clear();
+    if (_inotifyFd >= 0) {
+        close(_inotifyFd);
+    }
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyFd < 0) {
+        perror("DirectoryIndex::build");
+        return false;
+    }
+    _buildCount++;
+    if (!addDirectory(_root)) {
+        return false;
+    }
+    return addTree(_root);
+}
+
+void DirectoryIndex::handleEvents(const char* buffer, size_t length)
+{
+    std::lock_guard<std::shared_timed_mutex> lockGuard(_mtx);
+    for (size_t offset = 0; _watching && offset < length;) {
+        const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            // events were lost, so the index cannot be patched
+            if (!build()) {
+                disable();
+            }
+            return;
+        }
+        auto watched = _watchedDirectories.find(event->wd);
+        if (watched == _watchedDirectories.end()) {
+            continue;
+        }
+        std::string directory = watched->second;
+        if (event->mask & IN_IGNORED) {
+            _watchedDirectories.erase(watched);
+        }
+        if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+            if (directory == _root) {
+                // without the root, there is nothing to watch
+                disable();
+            }
+            continue;
+        }
+        if (event->len == 0) {
+            continue;
+        }
+
+        std::string name = event->name;
+        std::string path = childPath(directory, name);
+        if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+            if (event->mask & IN_ISDIR) {
+                removeDirectory(path);
+                _directories[directory].subdirectories.erase(name);
+            } else {
+                removeFile(directory, name);
+            }
+        } else if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+            if (event->mask & IN_ISDIR) {
+                // the watch is added before reading the directory, so no file created meanwhile is missed
+                if (!addDirectory(path)) {
+                    disable();
+                    return;
+                }
+                _directories[directory].subdirectories.insert(name);
+                if (!addTree(path)) {
+                    disable();
+                    return;
+                }
+            } else if (FileSystem::isFile(path)) {
+                addFile(directory, name);
+            }
+        }
+    }
+}
+
+/**
+ * Adds the content of the directory, which needs to be in the index already.
+ * @return False, if a subdirectory cannot be watched.
+ */
+bool DirectoryIndex::addTree(const std::string& directory)
+{
+    bool watched = true;
+    DirectoryWalker walker(false);
+    walker.walk(directory, [this, &watched](const DirectoryEntry& entry) {
+        std::string parent = entry.path.substr(0, entry.path.size() - strlen(entry.name) - 1);
+        if (parent.empty()) {
+            parent = "/";
+        }
+        if (entry.type == DirectoryEntryType::FILE) {
+            addFile(parent, entry.name);
+        } else if (entry.type == DirectoryEntryType::DIRECTORY) {
+            if (isSymlink(entry.path)) {
+                return WalkAction::SKIP_DIRECTORY;
+            }
+            if (!addDirectory(entry.path)) {
+                watched = false;
+                return WalkAction::STOP;
+            }
+            _directories[parent].subdirectories.insert(entry.name);
+        }
+        return WalkAction::CONTINUE;
+    });
+    return watched;
+}
+
+bool DirectoryIndex::addDirectory(const std::string& directory)
+{
+    int watch = inotify_add_watch(_inotifyFd, directory.c_str(), WATCH_MASK);
+    if (watch < 0) {
+        perror("DirectoryIndex: inotify_add_watch");
+        return false;
+    }
+    _watchedDirectories[watch] = directory;
+    _directories[directory].watch = watch;
+    return true;
+}
+
+void DirectoryIndex::removeDirectory(const std::string& directory)
+{
+    auto entry = _directories.find(directory);
+    if (entry == _directories.end()) {
+        return;
+    }
+    for (const std::string& subdirectory : entry->second.subdirectories) {
+        removeDirectory(childPath(directory, subdirectory));
+    }
+    for (const std::string& name : entry->second.files) {
+        auto paths = _pathsByName.find(name);
+        paths->second.erase(childPath(directory, name));
+        if (paths->second.empty()) {
+            _pathsByName.erase(paths);
+        }
+    }
+    // a moved directory keeps its watch, a deleted one has lost it already
+    auto watched = _watchedDirectories.find(entry->second.watch);
+    if (watched != _watchedDirectories.end() && watched->second == directory) {
+        inotify_rm_watch(_inotifyFd, entry->second.watch);
+        _watchedDirectories.erase(watched);
+    }
+    _directories.erase(entry);
+}
+
+void DirectoryIndex::addFile(const std::string& directory, const std::string& name)
+{
+    auto entry = _directories.find(directory);
+    if (entry == _directories.end()) {
+        return;
+    }
+    entry->second.files.insert(name);
+    _pathsByName[name].insert(childPath(directory, name));
+}
+
+void DirectoryIndex::removeFile(const std::string& directory, const std::string& name)
+{
+    auto entry = _directories.find(directory);
+    if (entry == _directories.end() || entry->second.files.erase(name) == 0) {
+        return;
+    }
+    auto paths = _pathsByName.find(name);
+    paths->second.erase(childPath(directory, name));
+    if (paths->second.empty()) {
+        _pathsByName.erase(paths);
+    }
+}
+
+/**
+ * Drops the index, so that the queries walk the tree. Needs the exclusive lock.
+ */
+void DirectoryIndex::disable()
+{
+    _watching = false;
+    _directories.clear();
+    _watchedDirectories.clear();
+    _pathsByName.clear();
+    if (_inotifyFd >= 0) {
+        close(_inotifyFd);
+        _inotifyFd = -1;
+    }
+}
+
+/**
+ * Removes one trailing separator, so that the paths of the index are built like the ones of the DirectoryWalker.
+ */
+std::string DirectoryIndex::normalise(const std::string& directory)
+{
+    if (directory.size() > 1 && directory.back() == FileSystem::PATH_SEPARATOR) {
+        return directory.substr(0, directory.size() - 1);
+    }
+    return directory;
+}
+
+std::string DirectoryIndex::childPath(const std::string& directory, const std::string& name)
+{
+    if (directory == "/") {
+        return directory + name;
+    }
+    return directory + FileSystem::PATH_SEPARATOR + name;
+}
+
+} // namespace essentials
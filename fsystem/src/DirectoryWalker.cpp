@@ -0,0 +1,471 @@
+#include "essentials/DirectoryWalker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <mutex>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace essentials
+{
+
+namespace
+{
+struct NameRef
+{
+    size_t offset; /** < The position of the name in the buffer of names. */
+    DirectoryEntryType type;
+};
+
+DirectoryEntryType typeOf(int dirFd, const struct dirent* entry)
+{
+    switch (entry->d_type) {
+    case DT_REG:
+        return DirectoryEntryType::FILE;
+    case DT_DIR:
+        return DirectoryEntryType::DIRECTORY;
+    case DT_UNKNOWN:
+    case DT_LNK:
+        break;
+    default:
+        return DirectoryEntryType::OTHER;
+    }
+
+    // the file system does not tell the type, or the target of the symlink matters
+    struct stat buf;
+    if (fstatat(dirFd, entry->d_name, &buf, 0) != 0) {
+        return DirectoryEntryType::OTHER;
+    }
+    if (S_ISDIR(buf.st_mode)) {
+        return DirectoryEntryType::DIRECTORY;
+    }
+    if (S_ISREG(buf.st_mode)) {
+        return DirectoryEntryType::FILE;
+    }
+    return DirectoryEntryType::OTHER;
+}
+
+bool isDotOrDotDot(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+void sortByName(const std::vector<char>& names, std::vector<NameRef>& refs)
+{
+    std::sort(refs.begin(), refs.end(), [&names](const NameRef& a, const NameRef& b) { return strcoll(names.data() + a.offset, names.data() + b.offset) < 0; });
+}
+} // namespace
+
+DirectoryWalker::DirectoryWalker(bool sorted)
+        : _sorted(sorted)
+{
+}
+
+bool DirectoryWalker::walk(const std::string& directory, const Visitor& visitor, bool recursive)
+{
+    int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        perror("DirectoryWalker::walk");
+        return false;
+    }
+    _path = directory;
+    if (!_path.empty() && _path.back() != '/') {
+        _path += '/';
+    }
+    _ancestors.clear();
+    walkDirectory(dirFd, visitor, recursive);
+    return true;
+}
+
+bool DirectoryWalker::walkDirectory(int dirFd, const Visitor& visitor, bool recursive)
+{
+    struct stat buf;
+    if (fstat(dirFd, &buf) != 0) {
+        perror("DirectoryWalker::walk");
+        close(dirFd);
+        return true;
+    }
+    std::pair<dev_t, ino_t> id(buf.st_dev, buf.st_ino);
+    if (std::find(_ancestors.begin(), _ancestors.end(), id) != _ancestors.end()) {
+        // reached by a symlink cycle, which would be walked until the descriptors run out
+        close(dirFd);
+        return true;
+    }
+
+    // takes ownership of the descriptor
+    DIR* dir = fdopendir(dirFd);
+    if (!dir) {
+        perror("DirectoryWalker::walk");
+        close(dirFd);
+        return true;
+    }
+
+    _ancestors.push_back(id);
+    std::vector<char> names;
+    std::vector<NameRef> refs;
+    bool proceed = true;
+    struct dirent* entry;
+    while (proceed && (entry = readdir(dir)) != nullptr) {
+        if (isDotOrDotDot(entry->d_name)) {
+            continue;
+        }
+        DirectoryEntryType type = typeOf(dirFd, entry);
+        if (_sorted) {
+            refs.push_back({names.size(), type});
+            names.insert(names.end(), entry->d_name, entry->d_name + strlen(entry->d_name) + 1);
+            continue;
+        }
+
+        proceed = visit(dirFd, entry->d_name, type, visitor, recursive);
+    }
+
+    if (_sorted) {
+        sortByName(names, refs);
+        for (size_t i = 0; proceed && i < refs.size(); i++) {
+            proceed = visit(dirFd, names.data() + refs[i].offset, refs[i].type, visitor, recursive);
+        }
+    }
+
+    closedir(dir);
+    _ancestors.pop_back();
+    return proceed;
+}
+
+bool DirectoryWalker::visit(int dirFd, const char* name, DirectoryEntryType type, const Visitor& visitor, bool recursive)
+{
+    size_t pathLength = _path.size();
+    _path.append(name);
+    bool proceed = true;
+    WalkAction action = visitor(DirectoryEntry{name, _path, type});
+    if (action == WalkAction::STOP) {
+        proceed = false;
+    } else if (recursive && type == DirectoryEntryType::DIRECTORY && action != WalkAction::SKIP_DIRECTORY) {
+        int subFd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (subFd < 0) {
+            perror("DirectoryWalker::walk");
+        } else {
+            _path += '/';
+            proceed = walkDirectory(subFd, visitor, recursive);
+        }
+    }
+    _path.resize(pathLength);
+    return proceed;
+}
+
+/**
+ * A directory of the parallel walk. The nodes form a tree, which keeps the matches
+ * and subdirectories in the order of their directory, so that they can be collected
+ * in a deterministic order once all threads are done.
+ */
+struct ParallelDirectoryWalker::Node
+{
+    struct Item
+    {
+        std::string match;           /** < The path of the entry, if it matched. */
+        std::unique_ptr<Node> child; /** < The node of the entry, if it is a directory that is walked. */
+    };
+
+    std::string path;               /** < The path of the directory, ending with a slash. */
+    std::vector<uint32_t> position; /** < The index of each directory on the way from the root in its sorted parent. */
+    std::vector<Item> items;
+    const Node* parent = nullptr; /** < Outlives the node, since it owns it. */
+    dev_t device = 0;
+    ino_t inode = 0;
+};
+
+/**
+ * The state shared by the threads of one call of collect.
+ */
+struct ParallelDirectoryWalker::Walk
+{
+    struct Queue
+    {
+        std::mutex mtx;
+        std::deque<Node*> nodes;
+    };
+
+    Walk(const ParallelWalkOptions& options, const Filter& filter, unsigned int threadCount);
+    void run(unsigned int index); /** < The method executed by each thread, returns once all nodes are processed. */
+    void push(unsigned int index, Node* node);
+    bool pop(unsigned int index, Node*& node);
+    void process(unsigned int index, Node* node);
+    bool isPruned(const std::vector<uint32_t>& position);
+    void addFirstMatch(const std::vector<uint32_t>& position);
+    static void flatten(const Node& node, std::vector<std::string>& matches);
+
+    const ParallelWalkOptions& options;
+    const Filter& filter;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> outstanding; /** < The number of nodes, which are queued or being processed. */
+    std::atomic<size_t> queued;
+    std::atomic<bool> stopped;
+    std::mutex idleMtx;
+    std::condition_variable idleCV;
+    std::mutex matchMtx;
+    std::vector<std::string> unorderedMatches; /** < The matches in the order they were found, if the walk is not deterministic. */
+    std::atomic<bool> hasFirstMatch;
+    std::vector<uint32_t> firstMatch; /** < The position of the first match known so far, if the walk stops at the first match. */
+};
+
+ParallelDirectoryWalker::Walk::Walk(const ParallelWalkOptions& options, const Filter& filter, unsigned int threadCount)
+        : options(options)
+        , filter(filter)
+        , outstanding(0)
+        , queued(0)
+        , stopped(false)
+        , hasFirstMatch(false)
+{
+    for (unsigned int i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+}
+
+void ParallelDirectoryWalker::Walk::run(unsigned int index)
+{
+    Node* node;
+    while (true) {
+        if (pop(index, node)) {
+            process(index, node);
+            if (--outstanding == 0) {
+                {
+                    // taking the lock avoids a lost wake-up of a thread that is about to sleep
+                    std::lock_guard<std::mutex> lockGuard(idleMtx);
+                }
+                idleCV.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMtx);
+        idleCV.wait(lock, [this] { return outstanding == 0 || queued > 0; });
+        if (outstanding == 0) {
+            return;
+        }
+    }
+}
+
+void ParallelDirectoryWalker::Walk::push(unsigned int index, Node* node)
+{
+    // counted before it is visible, so that outstanding never drops to zero early
+    outstanding++;
+    {
+        std::lock_guard<std::mutex> lockGuard(queues[index]->mtx);
+        queues[index]->nodes.push_back(node);
+    }
+    queued++;
+    {
+        std::lock_guard<std::mutex> lockGuard(idleMtx);
+    }
+    idleCV.notify_one();
+}
+
+/**
+ * Takes the newest node of the own queue, so that each thread walks depth-first,
+ * or steals the oldest node of another queue.
+ */
+bool ParallelDirectoryWalker::Walk::pop(unsigned int index, Node*& node)
+{
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lockGuard(own.mtx);
+        if (!own.nodes.empty()) {
+            node = own.nodes.back();
+            own.nodes.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lockGuard(victim.mtx);
+        if (!victim.nodes.empty()) {
+            node = victim.nodes.front();
+            victim.nodes.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelDirectoryWalker::Walk::process(unsigned int index, Node* node)
+{
+    if (stopped || isPruned(node->position)) {
+        return;
+    }
+    int dirFd = open(node->path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        perror("ParallelDirectoryWalker::collect");
+        return;
+    }
+    struct stat buf;
+    if (fstat(dirFd, &buf) != 0) {
+        perror("ParallelDirectoryWalker::collect");
+        close(dirFd);
+        return;
+    }
+    node->device = buf.st_dev;
+    node->inode = buf.st_ino;
+    for (const Node* ancestor = node->parent; ancestor; ancestor = ancestor->parent) {
+        if (ancestor->device == node->device && ancestor->inode == node->inode) {
+            // reached by a symlink cycle, see DirectoryWalker
+            close(dirFd);
+            return;
+        }
+    }
+    // takes ownership of the descriptor
+    DIR* dir = fdopendir(dirFd);
+    if (!dir) {
+        perror("ParallelDirectoryWalker::collect");
+        close(dirFd);
+        return;
+    }
+    std::vector<char> names;
+    std::vector<NameRef> refs;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (!isDotOrDotDot(entry->d_name)) {
+            refs.push_back({names.size(), typeOf(dirFd, entry)});
+            names.insert(names.end(), entry->d_name, entry->d_name + strlen(entry->d_name) + 1);
+        }
+    }
+    closedir(dir);
+    if (options.deterministic) {
+        sortByName(names, refs);
+    }
+
+    bool firstMatchOnly = options.stopAtFirstMatch && options.deterministic;
+    std::string path = node->path;
+    size_t pathLength = path.size();
+    std::vector<uint32_t> position = node->position;
+    position.push_back(0);
+    std::vector<Node*> children;
+    for (uint32_t i = 0; i < refs.size() && !stopped; i++) {
+        position.back() = i;
+        if (firstMatchOnly && isPruned(position)) {
+            // so are all following entries
+            break;
+        }
+        const char* name = names.data() + refs[i].offset;
+        path.resize(pathLength);
+        path.append(name);
+        bool isMatch = filter(DirectoryEntry{name, path, refs[i].type});
+        if (isMatch && !options.deterministic) {
+            std::lock_guard<std::mutex> lockGuard(matchMtx);
+            unorderedMatches.push_back(path);
+            if (options.stopAtFirstMatch) {
+                stopped = true;
+            }
+        } else if (isMatch && firstMatchOnly) {
+            addFirstMatch(position);
+        }
+
+        Node::Item item;
+        if (isMatch && options.deterministic) {
+            item.match = path;
+        }
+        // the content of a matching directory comes after the first match
+        if (refs[i].type == DirectoryEntryType::DIRECTORY && !(isMatch && firstMatchOnly)) {
+            item.child = std::make_unique<Node>();
+            item.child->path = path + '/';
+            item.child->parent = node;
+            if (firstMatchOnly) {
+                item.child->position = position;
+            }
+        }
+        if (item.match.empty() && !item.child) {
+            continue;
+        }
+        if (item.child) {
+            children.push_back(item.child.get());
+        }
+        node->items.push_back(std::move(item));
+    }
+    // the queue is taken from the back, so the first subdirectory is walked first
+    for (auto child = children.rbegin(); child != children.rend(); ++child) {
+        push(index, *child);
+    }
+}
+
+/**
+ * Checks whether the position comes after the first match known so far, in the order of a sorted, sequential walk.
+ */
+bool ParallelDirectoryWalker::Walk::isPruned(const std::vector<uint32_t>& position)
+{
+    if (!hasFirstMatch) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lockGuard(matchMtx);
+    return firstMatch < position;
+}
+
+void ParallelDirectoryWalker::Walk::addFirstMatch(const std::vector<uint32_t>& position)
+{
+    std::lock_guard<std::mutex> lockGuard(matchMtx);
+    if (!hasFirstMatch || position < firstMatch) {
+        firstMatch = position;
+        hasFirstMatch = true;
+    }
+}
+
+void ParallelDirectoryWalker::Walk::flatten(const Node& node, std::vector<std::string>& matches)
+{
+    for (const Node::Item& item : node.items) {
+        if (!item.match.empty()) {
+            matches.push_back(item.match);
+        }
+        if (item.child) {
+            flatten(*item.child, matches);
+        }
+    }
+}
+
+ParallelDirectoryWalker::ParallelDirectoryWalker(const ParallelWalkOptions& options)
+        : _options(options)
+{
+}
+
+std::vector<std::string> ParallelDirectoryWalker::collect(const std::string& directory, const Filter& filter)
+{
+    unsigned int threadCount = _options.threadCount;
+    if (threadCount == 0) {
+        // reading directories mostly waits for the file system, so more threads than cores help
+        threadCount = std::min(16u, 4 * std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    Walk walk(_options, filter, threadCount);
+    Node root;
+    root.path = directory;
+    if (!root.path.empty() && root.path.back() != '/') {
+        root.path += '/';
+    }
+    walk.push(0, &root);
+    // the calling thread is the first one of the pool
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.emplace_back(&Walk::run, &walk, i);
+    }
+    walk.run(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (!_options.deterministic) {
+        return std::move(walk.unorderedMatches);
+    }
+    std::vector<std::string> matches;
+    Walk::flatten(root, matches);
+    if (_options.stopAtFirstMatch && matches.size() > 1) {
+        matches.resize(1);
+    }
+    return matches;
+}
+
+} // namespace essentials
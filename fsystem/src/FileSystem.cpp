@@ -1,4 +1,5 @@
 #include "essentials/FileSystem.h"
+#include "essentials/DirectoryWalker.h"
 #include <cstring>
 #include <dirent.h>
 #include <fstream>
@@ -94,57 +95,24 @@ std::string FileSystem::getSelf()
 
 bool FileSystem::findFile(const std::string& path, const std::string& file, std::string& path_found)
 {
-    // cout << "ff: Path: " << path << " file: " << file << endl;
-
     if (!pathExists(path))
         return false;
 
-    struct dirent** namelist;
-    int i, n;
-    n = scandir(path.c_str(), &namelist, 0, alphasort);
-
-    if (n < 0) {
-        perror("FileSystem::findFile");
-        free(namelist);
-        return false;
-    }
-
     bool fileFound = false;
-    for (i = 0; i < n; i++) {
-        // cout << "ff: Namelist " << i << ": " << namelist[i]->d_name << endl;
-        std::string curFile = namelist[i]->d_name;
-        std::string curFullFile = combinePaths(path, curFile);
-        if (isDirectory(curFullFile)) {
-            // ignore current or parent directory
-            if (CURDIR.compare(curFile) == 0 || PARENTDIR.compare(curFile) == 0) {
-                free(namelist[i]);
-                continue;
-            }
-
-            // recursively call this method for regular directories
-            if (findFile(curFullFile + "/", file, path_found)) {
-                fileFound = true;
-                break;
-            }
-        } else if (isFile(curFullFile)) {
-            if (file.compare(namelist[i]->d_name) == 0) {
+    DirectoryWalker walker;
+    walker.walk(path, [&](const DirectoryEntry& entry) {
+        if (entry.type == DirectoryEntryType::FILE) {
+            if (file.compare(entry.name) == 0) {
                 // file found, so return the full path
                 fileFound = true;
-                path_found = curFullFile;
-                break;
+                path_found = entry.path;
+                return WalkAction::STOP;
             }
-        } else {
-            std::cout << "ff: Found a symlink, or something else, which is not a regular file or directory: " << curFullFile << std::endl;
+        } else if (entry.type == DirectoryEntryType::OTHER) {
+            std::cout << "ff: Found a symlink, or something else, which is not a regular file or directory: " << entry.path << std::endl;
         }
-
-        free(namelist[i]);
-    }
-
-    for (; i < n; i++) {
-        free(namelist[i]);
-    }
-
-    free(namelist);
+        return WalkAction::CONTINUE;
+    });
     return fileFound;
 }
 
@@ -156,39 +124,50 @@ std::vector<std::string> FileSystem::findAllFiles(std::string path, std::string
     }
 
     std::vector<std::string> files;
-    struct dirent** namelist;
-    int i, n;
-    n = scandir(path.c_str(), &namelist, 0, alphasort);
-
-    if (n < 0) {
-        perror("FileSystem::findAllFiles");
-        free(namelist);
-        return std::vector<std::string>();
-    }
+    DirectoryWalker walker;
+    walker.walk(path,
+            [&](const DirectoryEntry& entry) {
+                if (entry.type == DirectoryEntryType::FILE) {
+                    if (hasSuffix(entry.name, ending)) {
+                        files.push_back(entry.path);
+                    }
+                } else if (entry.type == DirectoryEntryType::OTHER) {
+                    std::cout << "FS: Found a symlink, or something else, which is not a regular file or directory: " << entry.path << std::endl;
+                }
+                return WalkAction::CONTINUE;
+            },
+            false);
+    return files;
+}
 
-    for (i = 0; i < n; i++) {
-        // cout << "ff: Namelist " << i << ": " << namelist[i]->d_name << endl;
-        std::string curFile = namelist[i]->d_name;
-        std::string curFullFile = combinePaths(path, curFile);
-        if (isDirectory(curFullFile)) {
-            continue;
-        } else if (isFile(curFullFile)) {
-            if (hasSuffix(namelist[i]->d_name, ending)) {
-                files.push_back(curFullFile);
-            }
-        } else {
-            std::cout << "FS: Found a symlink, or something else, which is not a regular file or directory: " << curFullFile << std::endl;
-        }
+bool FileSystem::findFileParallel(const std::string& path, const std::string& file, std::string& path_found, unsigned int threadCount)
+{
+    if (!pathExists(path))
+        return false;
 
-        free(namelist[i]);
+    ParallelWalkOptions options;
+    options.threadCount = threadCount;
+    options.stopAtFirstMatch = true;
+    ParallelDirectoryWalker walker(options);
+    auto found = walker.collect(path, [&file](const DirectoryEntry& entry) { return entry.type == DirectoryEntryType::FILE && file.compare(entry.name) == 0; });
+    if (found.empty()) {
+        return false;
     }
+    path_found = found.front();
+    return true;
+}
 
-    for (; i < n; i++) {
-        free(namelist[i]);
+std::vector<std::string> FileSystem::findAllFilesRecursive(const std::string& path, const std::string& ending, unsigned int threadCount)
+{
+    if (!pathExists(path)) {
+        std::cerr << "FS: Path '" << path << "' does not exists!" << std::endl;
+        return std::vector<std::string>();
     }
 
-    free(namelist);
-    return files;
+    ParallelWalkOptions options;
+    options.threadCount = threadCount;
+    ParallelDirectoryWalker walker(options);
+    return walker.collect(path, [&ending](const DirectoryEntry& entry) { return entry.type == DirectoryEntryType::FILE && hasSuffix(entry.name, ending); });
 }
 
 bool FileSystem::hasSuffix(const std::string& s, const std::string& suffix)
@@ -0,0 +1,200 @@
+#include "essentials/MappedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace essentials
+{
+
+namespace
+{
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+int toAdvice(AccessHint hint)
+{
+    switch (hint) {
+    case AccessHint::SEQUENTIAL:
+        return MADV_SEQUENTIAL;
+    case AccessHint::RANDOM:
+        return MADV_RANDOM;
+    case AccessHint::WILL_NEED:
+        return MADV_WILLNEED;
+    case AccessHint::HUGE_PAGES:
+#ifdef MADV_HUGEPAGE
+        return MADV_HUGEPAGE;
+#else
+        return -1;
+#endif
+    default:
+        return MADV_NORMAL;
+    }
+}
+
+/**
+ * Maps the file at an address aligned to huge pages, by reserving a larger range
+ * first and placing the file at its first aligned address.
+ */
+void* mapAligned(int fd, size_t size, size_t& mappingSize)
+{
+    size_t reservedSize = size + HUGE_PAGE_SIZE;
+    void* reserved = mmap(nullptr, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(reserved);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    void* mapping = mmap(reinterpret_cast<void*>(aligned), size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        munmap(reserved, reservedSize);
+        errno = error;
+        return MAP_FAILED;
+    }
+    // release the reserved pages around the file
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    mappingSize = (size + pageSize - 1) & ~(pageSize - 1);
+    if (aligned > start) {
+        munmap(reserved, aligned - start);
+    }
+    uintptr_t mappingEnd = aligned + mappingSize;
+    if (start + reservedSize > mappingEnd) {
+        munmap(reinterpret_cast<void*>(mappingEnd), start + reservedSize - mappingEnd);
+    }
+    return mapping;
+}
+} // namespace
+
+MappedFile::MappedFile()
+        : _data(nullptr)
+        , _size(0)
+        , _mapping(nullptr)
+        , _mappingSize(0)
+        , _open(false)
+{
+}
+
+MappedFile::MappedFile(const std::string& path, AccessHint hint)
+        : MappedFile()
+{
+    open(path, hint);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+        : MappedFile()
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_mapping, other._mapping);
+        std::swap(_mappingSize, other._mappingSize);
+        std::swap(_open, other._open);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, AccessHint hint)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("MappedFile::open");
+        return false;
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) != 0) {
+        perror("MappedFile::open");
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(buf.st_mode)) {
+        errno = EINVAL;
+        perror("MappedFile::open");
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(buf.st_size);
+    if (size == 0) {
+        // an empty mapping is not allowed, but an empty file is still a valid file
+        ::close(fd);
+        _open = true;
+        return true;
+    }
+    void* mapping = MAP_FAILED;
+    size_t mappingSize = size;
+    if (hint == AccessHint::HUGE_PAGES && size >= HUGE_PAGE_SIZE) {
+        mapping = mapAligned(fd, size, mappingSize);
+    }
+    if (mapping == MAP_FAILED) {
+        // the alignment only helps huge pages, so the file is mapped anyway
+        mappingSize = size;
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // the mapping keeps the file open
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        perror("MappedFile::open");
+        return false;
+    }
+
+    _mapping = mapping;
+    _mappingSize = mappingSize;
+    _data = static_cast<const uint8_t*>(mapping);
+    _size = size;
+    _open = true;
+    if (hint != AccessHint::NORMAL) {
+        advise(hint);
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_mapping) {
+        munmap(_mapping, _mappingSize);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _open = false;
+}
+
+bool MappedFile::advise(AccessHint hint, size_t offset, size_t length)
+{
+    if (!_mapping || offset >= _size) {
+        return false;
+    }
+    int advice = toAdvice(hint);
+    if (advice < 0) {
+        errno = EINVAL;
+        perror("MappedFile::advise");
+        return false;
+    }
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset & ~(pageSize - 1);
+    length = std::min(length, _size - offset) + (offset - start);
+    if (madvise(static_cast<uint8_t*>(_mapping) + start, length, advice) != 0) {
+        perror("MappedFile::advise");
+        return false;
+    }
+    return true;
+}
+
+} // namespace essentials
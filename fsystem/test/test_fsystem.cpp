@@ -0,0 +1,635 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <essentials/DirectoryIndex.h>
+#include <essentials/DirectoryWalker.h>
+#include <essentials/FileSystem.h>
+#include <essentials/MappedFile.h>
+
+namespace
+{
+std::atomic<bool> hideEntryTypes{false};
+std::atomic<int> hiddenEntryTypes{0};
+std::atomic<bool> failInotify{false};
+std::atomic<bool> stallWatches{false};
+std::atomic<bool> watchStalled{false};
+std::atomic<bool> failHugePages{false};
+} // namespace
+
+/**
+ * Replaces readdir of the C library, so that the tests can walk a file system,
+ * which does not fill in the d_type of the entries.
+ */
+extern "C" struct dirent* readdir(DIR* dir)
+{
+    using Readdir = struct dirent* (*)(DIR*);
+    static Readdir realReaddir = reinterpret_cast<Readdir>(dlsym(RTLD_NEXT, "readdir"));
+    struct dirent* entry = realReaddir(dir);
+    if (entry && hideEntryTypes) {
+        entry->d_type = DT_UNKNOWN;
+        hiddenEntryTypes++;
+    }
+    return entry;
+}
+
+/**
+ * Replaces inotify_init1 of the C library, so that the tests can run without inotify.
+ */
+extern "C" int inotify_init1(int flags) noexcept
+{
+    using InotifyInit1 = int (*)(int);
+    static InotifyInit1 realInotifyInit1 = reinterpret_cast<InotifyInit1>(dlsym(RTLD_NEXT, "inotify_init1"));
+    if (failInotify) {
+        errno = EMFILE;
+        return -1;
+    }
+    return realInotifyInit1(flags);
+}
+
+/**
+ * Replaces inotify_add_watch of the C library, so that the tests can hold the thread of a
+ * DirectoryIndex, while the events pile up in the queue of the kernel.
+ */
+extern "C" int inotify_add_watch(int fd, const char* name, uint32_t mask) noexcept
+{
+    using InotifyAddWatch = int (*)(int, const char*, uint32_t);
+    static InotifyAddWatch realInotifyAddWatch = reinterpret_cast<InotifyAddWatch>(dlsym(RTLD_NEXT, "inotify_add_watch"));
+    while (stallWatches) {
+        watchStalled = true;
+        std::this_thread::yield();
+    }
+    return realInotifyAddWatch(fd, name, mask);
+}
+
+/**
+ * Replaces mmap of the C library, so that the tests can fail the address space reservation
+ * of a MappedFile, which aligns the mapping for huge pages.
+ */
+extern "C" void* mmap(void* address, size_t length, int protection, int flags, int fd, off_t offset) noexcept
+{
+    using Mmap = void* (*)(void*, size_t, int, int, int, off_t);
+    static Mmap realMmap = reinterpret_cast<Mmap>(dlsym(RTLD_NEXT, "mmap"));
+    if (failHugePages && protection == PROT_NONE) {
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+    return realMmap(address, length, protection, flags, fd, offset);
+}
+
+/**
+ * Replaces madvise of the C library, so that the tests can run on a kernel without huge pages for files.
+ */
+extern "C" int madvise(void* address, size_t length, int advice) noexcept
+{
+    using Madvise = int (*)(void*, size_t, int);
+    static Madvise realMadvise = reinterpret_cast<Madvise>(dlsym(RTLD_NEXT, "madvise"));
+    if (failHugePages && advice == MADV_HUGEPAGE) {
+        errno = EINVAL;
+        return -1;
+    }
+    return realMadvise(address, length, advice);
+}
+
+/**
+ * Creates a directory tree below a temporary directory and removes it again:
+ *
+ *   a.txt, b.txt, broken -> missing, dir1/{sub/y.cfg, x.cfg}, dir2/x.cfg, link_dir -> dir2, link_file -> a.txt
+ */
+class TemporaryTree : public ::testing::Test
+{
+public:
+    std::string root;
+
+    void SetUp() override
+    {
+        char name[] = "/tmp/fsystem-test-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(name));
+        root = name;
+        makeFile("a.txt");
+        makeFile("b.txt");
+        makeDirectory("dir1");
+        makeDirectory("dir1/sub");
+        makeFile("dir1/sub/y.cfg");
+        makeFile("dir1/x.cfg");
+        makeDirectory("dir2");
+        makeFile("dir2/x.cfg");
+        makeSymlink("missing", "broken");
+        makeSymlink("dir2", "link_dir");
+        makeSymlink("a.txt", "link_file");
+    }
+
+    void TearDown() override { removeTree(root); }
+
+    static void removeTree(const std::string& directory)
+    {
+        nftw(directory.c_str(), [](const char* path, const struct stat*, int, struct FTW*) { return remove(path); }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string path(const std::string& relative) const { return root + "/" + relative; }
+    void makeDirectory(const std::string& relative) { ASSERT_EQ(0, mkdir(path(relative).c_str(), 0777)); }
+    void makeFile(const std::string& relative, const std::string& content = "")
+    {
+        std::ofstream file(path(relative));
+        file << content;
+        ASSERT_TRUE(file.good());
+    }
+    void makeSymlink(const std::string& target, const std::string& relative) { ASSERT_EQ(0, symlink(target.c_str(), path(relative).c_str())); }
+
+    /**
+     * Adds the directory branches/b0 to b5, each with the subdirectories c0 to c3 and some files.
+     * Only some of the subdirectories contain a match.cfg, the first one in branches/b2/c1.
+     */
+    void makeBranches()
+    {
+        makeDirectory("branches");
+        for (int b = 0; b < 6; b++) {
+            std::string branch = "branches/b" + std::to_string(b);
+            makeDirectory(branch);
+            makeFile(branch + "/readme.txt");
+            for (int c = 0; c < 4; c++) {
+                std::string leaf = branch + "/c" + std::to_string(c);
+                makeDirectory(leaf);
+                makeFile(leaf + "/data.bin");
+                makeFile(leaf + "/other.cfg");
+                if (b >= 2 && (b + c) % 3 == 0) {
+                    makeFile(leaf + "/match.cfg");
+                }
+            }
+        }
+    }
+
+    /**
+     * The entries of a walk, relative to the root.
+     */
+    std::vector<std::pair<std::string, essentials::DirectoryEntryType>> walk(bool sorted = true)
+    {
+        std::vector<std::pair<std::string, essentials::DirectoryEntryType>> entries;
+        essentials::DirectoryWalker walker(sorted);
+        EXPECT_TRUE(walker.walk(root, [this, &entries](const essentials::DirectoryEntry& entry) {
+            entries.emplace_back(entry.path.substr(root.size() + 1), entry.type);
+            return essentials::WalkAction::CONTINUE;
+        }));
+        return entries;
+    }
+};
+
+/**
+ * FileSystem::findFile, as it was implemented with scandir and stat before the DirectoryWalker.
+ */
+bool findFileWithScandir(const std::string& path, const std::string& file, std::string& path_found)
+{
+    struct dirent** namelist;
+    int n = scandir(path.c_str(), &namelist, 0, alphasort);
+    if (n < 0) {
+        return false;
+    }
+    bool fileFound = false;
+    for (int i = 0; i < n; i++) {
+        std::string curFile = namelist[i]->d_name;
+        std::string curFullFile = essentials::FileSystem::combinePaths(path, curFile);
+        if (!fileFound && curFile != "." && curFile != "..") {
+            if (essentials::FileSystem::isDirectory(curFullFile)) {
+                fileFound = findFileWithScandir(curFullFile + "/", file, path_found);
+            } else if (essentials::FileSystem::isFile(curFullFile) && file == curFile) {
+                fileFound = true;
+                path_found = curFullFile;
+            }
+        }
+        free(namelist[i]);
+    }
+    free(namelist);
+    return fileFound;
+}
+
+/**
+ * FileSystem::findAllFiles, as it was implemented with scandir and stat before the DirectoryWalker.
+ */
+std::vector<std::string> findAllFilesWithScandir(const std::string& path, const std::string& ending)
+{
+    std::vector<std::string> files;
+    struct dirent** namelist;
+    int n = scandir(path.c_str(), &namelist, 0, alphasort);
+    if (n < 0) {
+        return files;
+    }
+    for (int i = 0; i < n; i++) {
+        std::string curFullFile = essentials::FileSystem::combinePaths(path, namelist[i]->d_name);
+        if (!essentials::FileSystem::isDirectory(curFullFile) && essentials::FileSystem::isFile(curFullFile) &&
+                essentials::FileSystem::hasSuffix(namelist[i]->d_name, ending)) {
+            files.push_back(curFullFile);
+        }
+        free(namelist[i]);
+    }
+    free(namelist);
+    return files;
+}
+
+TEST_F(TemporaryTree, walkerVisitsSortedEntriesDepthFirst)
+{
+    using Type = essentials::DirectoryEntryType;
+    std::vector<std::pair<std::string, Type>> expected{{"a.txt", Type::FILE}, {"b.txt", Type::FILE}, {"broken", Type::OTHER},
+            {"dir1", Type::DIRECTORY}, {"dir1/sub", Type::DIRECTORY}, {"dir1/sub/y.cfg", Type::FILE}, {"dir1/x.cfg", Type::FILE},
+            {"dir2", Type::DIRECTORY}, {"dir2/x.cfg", Type::FILE}, {"link_dir", Type::DIRECTORY}, {"link_dir/x.cfg", Type::FILE},
+            {"link_file", Type::FILE}};
+    EXPECT_EQ(expected, walk());
+
+    // the same entries, only in the order of the file system
+    auto unsorted = walk(false);
+    std::sort(unsorted.begin(), unsorted.end());
+    EXPECT_EQ(expected, unsorted);
+}
+
+TEST_F(TemporaryTree, walkerTypesEntriesOfUnknownTypeWithFstatat)
+{
+    auto expected = walk();
+    hideEntryTypes = true;
+    hiddenEntryTypes = 0;
+    auto entries = walk();
+    hideEntryTypes = false;
+    EXPECT_GT(hiddenEntryTypes.load(), 0);
+    EXPECT_EQ(expected, entries);
+}
+
+TEST_F(TemporaryTree, walkerSkipsDirectoriesAndStops)
+{
+    std::vector<std::string> visited;
+    essentials::DirectoryWalker walker;
+    EXPECT_TRUE(walker.walk(root, [this, &visited](const essentials::DirectoryEntry& entry) {
+        visited.push_back(entry.path.substr(root.size() + 1));
+        if (visited.back() == "dir1") {
+            return essentials::WalkAction::SKIP_DIRECTORY;
+        }
+        if (visited.back() == "dir2/x.cfg") {
+            return essentials::WalkAction::STOP;
+        }
+        return essentials::WalkAction::CONTINUE;
+    }));
+    std::vector<std::string> expected{"a.txt", "b.txt", "broken", "dir1", "dir2", "dir2/x.cfg"};
+    EXPECT_EQ(expected, visited);
+
+    visited.clear();
+    EXPECT_TRUE(walker.walk(root, [this, &visited](const essentials::DirectoryEntry& entry) {
+        visited.push_back(entry.path.substr(root.size() + 1));
+        return essentials::WalkAction::CONTINUE;
+    }, false));
+    expected = {"a.txt", "b.txt", "broken", "dir1", "dir2", "link_dir", "link_file"};
+    EXPECT_EQ(expected, visited);
+
+    EXPECT_FALSE(walker.walk(path("missing"), [](const essentials::DirectoryEntry&) { return essentials::WalkAction::CONTINUE; }));
+}
+
+TEST_F(TemporaryTree, walkersDoNotFollowSymlinkCycles)
+{
+    // both lead back to a directory on the path to them
+    makeSymlink("..", "dir1/up");
+    makeSymlink(".", "dir2/self");
+    using Type = essentials::DirectoryEntryType;
+    std::vector<std::pair<std::string, Type>> expected{{"a.txt", Type::FILE}, {"b.txt", Type::FILE}, {"broken", Type::OTHER},
+            {"dir1", Type::DIRECTORY}, {"dir1/sub", Type::DIRECTORY}, {"dir1/sub/y.cfg", Type::FILE}, {"dir1/up", Type::DIRECTORY},
+            {"dir1/x.cfg", Type::FILE}, {"dir2", Type::DIRECTORY}, {"dir2/self", Type::DIRECTORY}, {"dir2/x.cfg", Type::FILE},
+            {"link_dir", Type::DIRECTORY}, {"link_dir/self", Type::DIRECTORY}, {"link_dir/x.cfg", Type::FILE}, {"link_file", Type::FILE}};
+    EXPECT_EQ(expected, walk());
+
+    std::string found;
+    EXPECT_FALSE(essentials::FileSystem::findFile(root, "missing", found));
+    EXPECT_TRUE(essentials::FileSystem::findFile(path("dir1/sub"), "y.cfg", found));
+    EXPECT_EQ(path("dir1/sub/y.cfg"), found);
+    std::vector<std::string> configs{path("dir1/sub/y.cfg"), path("dir1/x.cfg"), path("dir2/x.cfg"), path("link_dir/x.cfg")};
+    for (unsigned int threadCount : {1u, 4u}) {
+        EXPECT_FALSE(essentials::FileSystem::findFileParallel(root, "missing", found, threadCount));
+        EXPECT_EQ(configs, essentials::FileSystem::findAllFilesRecursive(root, ".cfg", threadCount));
+    }
+}
+
+TEST_F(TemporaryTree, findFileAndFindAllFilesMatchTheScandirImplementation)
+{
+    for (const std::string& directory : {root, root + "/", path("dir1")}) {
+        for (const char* file : {"a.txt", "x.cfg", "y.cfg", "link_file", "broken", "sub", "missing"}) {
+            std::string found;
+            std::string expected;
+            EXPECT_EQ(findFileWithScandir(directory, file, expected), essentials::FileSystem::findFile(directory, file, found)) << directory << " " << file;
+            EXPECT_EQ(expected, found) << directory << " " << file;
+        }
+        for (const char* ending : {"", ".txt", ".cfg", "file"}) {
+            EXPECT_EQ(findAllFilesWithScandir(directory, ending), essentials::FileSystem::findAllFiles(directory, ending)) << directory << " " << ending;
+        }
+    }
+    std::string found;
+    EXPECT_TRUE(essentials::FileSystem::findFile(root, "x.cfg", found));
+    EXPECT_EQ(path("dir1/x.cfg"), found);
+}
+
+/**
+ * The matches of a sorted, sequential walk, which the parallel walker has to reproduce.
+ */
+std::vector<std::string> collectSequentially(const std::string& directory, const essentials::ParallelDirectoryWalker::Filter& filter)
+{
+    std::vector<std::string> matches;
+    essentials::DirectoryWalker walker;
+    walker.walk(directory, [&filter, &matches](const essentials::DirectoryEntry& entry) {
+        if (filter(entry)) {
+            matches.push_back(entry.path);
+        }
+        return essentials::WalkAction::CONTINUE;
+    });
+    return matches;
+}
+
+TEST_F(TemporaryTree, parallelWalkerFindsTheMatchesOfASortedWalk)
+{
+    makeBranches();
+    auto isConfig = [](const essentials::DirectoryEntry& entry) {
+        return entry.type == essentials::DirectoryEntryType::FILE && essentials::FileSystem::hasSuffix(entry.name, ".cfg");
+    };
+    auto isMatch = [](const essentials::DirectoryEntry& entry) { return strcmp(entry.name, "match.cfg") == 0; };
+    auto isDirectory = [](const essentials::DirectoryEntry& entry) { return entry.type == essentials::DirectoryEntryType::DIRECTORY; };
+    std::vector<std::string> configs = collectSequentially(root, isConfig);
+    std::vector<std::string> directories = collectSequentially(root, isDirectory);
+    // other.cfg in every leaf, five match.cfg and the four cfg files of the fixture
+    ASSERT_EQ(6u * 4 + 5 + 4, configs.size());
+    ASSERT_EQ(path("branches/b2/c1/match.cfg"), collectSequentially(root, isMatch).front());
+
+    for (unsigned int threadCount : {1u, 2u, 4u, 8u}) {
+        for (int repetition = 0; repetition < 5; repetition++) {
+            essentials::ParallelWalkOptions options;
+            options.threadCount = threadCount;
+            essentials::ParallelDirectoryWalker walker(options);
+            EXPECT_EQ(configs, walker.collect(root, isConfig)) << threadCount;
+            EXPECT_EQ(directories, walker.collect(root, isDirectory)) << threadCount;
+
+            options.stopAtFirstMatch = true;
+            essentials::ParallelDirectoryWalker firstMatchWalker(options);
+            EXPECT_EQ(std::vector<std::string>{path("branches/b2/c1/match.cfg")}, firstMatchWalker.collect(root, isMatch)) << threadCount;
+            EXPECT_EQ(std::vector<std::string>{path("a.txt")}, firstMatchWalker.collect(root, [](const essentials::DirectoryEntry&) { return true; }));
+            EXPECT_TRUE(firstMatchWalker.collect(root, [](const essentials::DirectoryEntry&) { return false; }).empty());
+
+            // without a deterministic order, the matches are the same, but in any order
+            options.stopAtFirstMatch = false;
+            options.deterministic = false;
+            essentials::ParallelDirectoryWalker unorderedWalker(options);
+            std::vector<std::string> unordered = unorderedWalker.collect(root, isConfig);
+            std::vector<std::string> sortedConfigs = configs;
+            std::sort(unordered.begin(), unordered.end());
+            std::sort(sortedConfigs.begin(), sortedConfigs.end());
+            EXPECT_EQ(sortedConfigs, unordered) << threadCount;
+
+            std::string found;
+            std::string expected;
+            EXPECT_EQ(essentials::FileSystem::findFile(root, "match.cfg", expected), essentials::FileSystem::findFileParallel(root, "match.cfg", found, threadCount));
+            EXPECT_EQ(expected, found);
+            EXPECT_FALSE(essentials::FileSystem::findFileParallel(root, "missing", found, threadCount));
+            EXPECT_EQ(configs, essentials::FileSystem::findAllFilesRecursive(root, ".cfg", threadCount));
+        }
+    }
+}
+
+/**
+ * Waits until the index gives the same answers as walking the tree, as it applies the changes in the background.
+ */
+bool agreesWithDisk(const essentials::DirectoryIndex& index, const std::string& root, const std::vector<std::string>& names)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (true) {
+        bool agrees = true;
+        for (const std::string& name : names) {
+            std::string indexed;
+            std::string walked;
+            agrees = agrees && index.findFile(name, indexed) == essentials::FileSystem::findFile(root, name, walked) && indexed == walked;
+        }
+        essentials::DirectoryWalker walker;
+        walker.walk(root, [&index, &agrees](const essentials::DirectoryEntry& entry) {
+            if (entry.type == essentials::DirectoryEntryType::DIRECTORY) {
+                agrees = agrees && index.findAllFiles(entry.path, "") == essentials::FileSystem::findAllFiles(entry.path, "");
+            }
+            return agrees ? essentials::WalkAction::CONTINUE : essentials::WalkAction::STOP;
+        });
+        if (agrees || std::chrono::steady_clock::now() > deadline) {
+            return agrees;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST_F(TemporaryTree, directoryIndexFollowsChangesOfTheTree)
+{
+    makeBranches();
+    makeDirectory("outside");
+    makeDirectory("outside/moved");
+    makeFile("outside/moved/moved_in.txt");
+    makeDirectory("outside/moved/deep");
+    makeFile("outside/moved/deep/deep.txt");
+    const std::vector<std::string> names{"readme.txt", "match.cfg", "other.cfg", "data.bin", "created.txt", "moved_in.txt", "deep.txt", "marker.txt"};
+    std::string found;
+
+    essentials::DirectoryIndex index(path("branches"));
+    ASSERT_TRUE(index.isWatching());
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("match.cfg", found));
+    EXPECT_EQ(path("branches/b2/c1/match.cfg"), found);
+
+    // a directory with content, created right after the directory itself
+    makeFile("branches/b3/created.txt");
+    makeDirectory("branches/b0/new");
+    makeFile("branches/b0/new/created.txt");
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("created.txt", found));
+    EXPECT_EQ(path("branches/b0/new/created.txt"), found);
+
+    ASSERT_EQ(0, rename(path("outside/moved").c_str(), path("branches/b1/moved").c_str()));
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("deep.txt", found));
+    EXPECT_EQ(path("branches/b1/moved/deep/deep.txt"), found);
+
+    ASSERT_EQ(0, rename(path("branches/b1/moved").c_str(), path("branches/b4/moved").c_str()));
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("deep.txt", found));
+    EXPECT_EQ(path("branches/b4/moved/deep/deep.txt"), found);
+
+    ASSERT_EQ(0, rename(path("branches/b4/moved").c_str(), path("outside/moved").c_str()));
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_FALSE(index.findFile("deep.txt", found));
+    // the events are applied in order, so the file outside is ignored, once the marker is found
+    makeFile("outside/moved/deep/late.txt");
+    makeFile("branches/b5/marker.txt");
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_FALSE(index.findFile("late.txt", found));
+
+    removeTree(path("branches/b2"));
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("match.cfg", found));
+    EXPECT_EQ(path("branches/b3/c0/match.cfg"), found);
+    EXPECT_TRUE(index.findAllFiles(path("branches/b2/c1"), "").empty());
+
+    EXPECT_TRUE(index.isWatching());
+    EXPECT_EQ(1u, index.getBuildCount());
+}
+
+TEST_F(TemporaryTree, directoryIndexRebuildsAfterLostEvents)
+{
+    makeBranches();
+    int maxQueuedEvents = 16384;
+    std::ifstream("/proc/sys/fs/inotify/max_queued_events") >> maxQueuedEvents;
+    const std::vector<std::string> names{"readme.txt", "match.cfg", "stalled.txt", "after.txt"};
+    essentials::DirectoryIndex index(path("branches"));
+    ASSERT_TRUE(index.isWatching());
+
+    // holds the thread of the index at the watch of the new directory, so that the queue overflows
+    stallWatches = true;
+    makeDirectory("branches/b0/stall");
+    while (!watchStalled) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < maxQueuedEvents; i++) {
+        makeFile("branches/b1/churn.txt");
+        ASSERT_EQ(0, unlink(path("branches/b1/churn.txt").c_str()));
+    }
+    makeFile("branches/b0/stall/stalled.txt");
+    stallWatches = false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (index.getBuildCount() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(2u, index.getBuildCount());
+    EXPECT_TRUE(index.isWatching());
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    std::string found;
+    EXPECT_TRUE(index.findFile("stalled.txt", found));
+
+    // the new inotify instance follows the changes again
+    makeFile("branches/b2/after.txt");
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+    EXPECT_TRUE(index.findFile("after.txt", found));
+    EXPECT_EQ(2u, index.getBuildCount());
+}
+
+TEST_F(TemporaryTree, directoryIndexWalksTheTreeWithoutInotify)
+{
+    makeBranches();
+    const std::vector<std::string> names{"readme.txt", "match.cfg", "created.txt"};
+    failInotify = true;
+    essentials::DirectoryIndex index(path("branches"));
+    failInotify = false;
+    EXPECT_FALSE(index.isWatching());
+    EXPECT_EQ(0u, index.getBuildCount());
+    EXPECT_TRUE(agreesWithDisk(index, path("branches"), names));
+
+    // answered from disk, so changes are seen right away
+    makeFile("branches/b0/created.txt");
+    std::string found;
+    EXPECT_TRUE(index.findFile("created.txt", found));
+    EXPECT_EQ(path("branches/b0/created.txt"), found);
+    removeTree(path("branches/b2"));
+    EXPECT_TRUE(index.findFile("match.cfg", found));
+    EXPECT_EQ(path("branches/b3/c0/match.cfg"), found);
+}
+
+TEST_F(TemporaryTree, mappedFileMapsTheContent)
+{
+    makeFile("content.txt", "hello\nworld");
+    essentials::MappedFile file(path("content.txt"));
+    ASSERT_TRUE(file.isOpen());
+    EXPECT_FALSE(file.empty());
+    EXPECT_EQ(11u, file.size());
+    EXPECT_EQ("hello\nworld", file.toString());
+    EXPECT_EQ(11, std::count_if(file.begin(), file.end(), [](uint8_t) { return true; }));
+    EXPECT_EQ('w', file.chars()[6]);
+
+    essentials::MappedFile moved(std::move(file));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(nullptr, file.bytes());
+    EXPECT_EQ("hello\nworld", moved.toString());
+    moved.close();
+    EXPECT_FALSE(moved.isOpen());
+    EXPECT_EQ(0u, moved.size());
+}
+
+TEST_F(TemporaryTree, mappedFileOpensEmptyFilesWithoutMapping)
+{
+    makeFile("empty.txt");
+    essentials::MappedFile file(path("empty.txt"), essentials::AccessHint::SEQUENTIAL);
+    EXPECT_TRUE(file.isOpen());
+    EXPECT_TRUE(file.empty());
+    EXPECT_EQ(nullptr, file.bytes());
+    EXPECT_EQ(file.begin(), file.end());
+    EXPECT_EQ("", file.toString());
+    EXPECT_FALSE(file.advise(essentials::AccessHint::WILL_NEED));
+}
+
+TEST_F(TemporaryTree, mappedFileFailsForMissingFilesAndDirectories)
+{
+    essentials::MappedFile file;
+    EXPECT_FALSE(file.open(path("missing")));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_FALSE(file.open(path("dir1")));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_FALSE(file.open(path("broken")));
+    EXPECT_FALSE(file.isOpen());
+
+    // a failed open closes the file opened before
+    EXPECT_TRUE(file.open(path("link_file")));
+    EXPECT_FALSE(file.open(path("missing")));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(nullptr, file.bytes());
+}
+
+TEST_F(TemporaryTree, mappedFileFallsBackWhenHintsAreNotSupported)
+{
+    makeFile("small.txt", "small");
+    // larger than a huge page, so that the mapping is aligned to one
+    std::string content(3 * 1024 * 1024 + 17, 'x');
+    content.back() = 'y';
+    makeFile("large.bin", content);
+
+    essentials::MappedFile small(path("small.txt"), essentials::AccessHint::HUGE_PAGES);
+    ASSERT_TRUE(small.isOpen());
+    EXPECT_EQ("small", small.toString());
+    EXPECT_TRUE(small.advise(essentials::AccessHint::RANDOM));
+    EXPECT_TRUE(small.advise(essentials::AccessHint::SEQUENTIAL, 3, 1));
+    EXPECT_FALSE(small.advise(essentials::AccessHint::NORMAL, 5));
+
+    // whether the kernel backs file mappings by huge pages or not, the content stays readable
+    essentials::MappedFile large(path("large.bin"), essentials::AccessHint::HUGE_PAGES);
+    ASSERT_TRUE(large.isOpen());
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(large.bytes()) % (2 * 1024 * 1024));
+    large.advise(essentials::AccessHint::HUGE_PAGES);
+    EXPECT_EQ(content, large.toString());
+    EXPECT_TRUE(large.advise(essentials::AccessHint::WILL_NEED, 2 * 1024 * 1024 + 1));
+    EXPECT_EQ('y', large.chars()[large.size() - 1]);
+
+    // neither the aligned mapping nor the hint are available, the file is mapped anyway
+    failHugePages = true;
+    essentials::MappedFile unaligned(path("large.bin"), essentials::AccessHint::HUGE_PAGES);
+    EXPECT_FALSE(unaligned.advise(essentials::AccessHint::HUGE_PAGES));
+    failHugePages = false;
+    ASSERT_TRUE(unaligned.isOpen());
+    EXPECT_EQ(content, unaligned.toString());
+    EXPECT_TRUE(unaligned.advise(essentials::AccessHint::RANDOM));
+    unaligned.close();
+    EXPECT_FALSE(unaligned.isOpen());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "essentials/IdentifierConstPtr.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace essentials
+{
+
+/**
+ * Maps (sender ID, topic) keys to handler slots, where the sender may also be
+ * the wildcard ID. For every exact key, the slots of the wildcard subscriptions
+ * of the same topic are merged in advance, so routing a message is a single hash
+ * lookup followed by a scan over exactly the slots to call. Senders without an
+ * exact subscription fall back to the precomputed wildcard list of the topic.
+ *
+ * Senders are compared by pointer, so they need to be managed by the same IDManager.
+ * A null sender is treated like the wildcard ID.
+ * The index is not synchronised, because subscriptions are expected to change
+ * rarely compared to routing. Guard it with a lock of your choice, if needed.
+ * @tparam Topic The second part of the key, e.g., a message type.
+ * @tparam Slot The handler stored per subscription. It needs to be equality comparable for unsubscribing.
+ */
+template <class Topic, class Slot, class TopicHash = std::hash<Topic>>
+class IDDispatchIndex
+{
+public:
+    void subscribe(IdentifierConstPtr sender, const Topic& topic, const Slot& slot);
+    /**
+     * Removes one subscription of the given slot.
+     * @return False, if there was no such subscription.
+     */
+    bool unsubscribe(IdentifierConstPtr sender, const Topic& topic, const Slot& slot);
+    /**
+     * Returns the slots of all subscriptions matching the given key, i.e., the exact ones
+     * followed by the wildcard ones of the topic.
+     */
+    const std::vector<Slot>& lookup(IdentifierConstPtr sender, const Topic& topic) const;
+    template <class Visitor>
+    void dispatch(IdentifierConstPtr sender, const Topic& topic, Visitor&& visitor) const;
+    bool empty() const { return _exact.empty() && _wildcard.empty(); }
+
+private:
+    struct Key
+    {
+        IdentifierConstPtr sender;
+        Topic topic;
+        bool operator==(const Key& other) const { return sender == other.sender && topic == other.topic; }
+    };
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const { return key.sender.hash() * 31 + TopicHash()(key.topic); }
+    };
+    struct Entry
+    {
+        std::vector<Slot> exactSlots;
+        std::vector<Slot> slots; /** < exactSlots followed by the wildcard slots of the topic */
+    };
+
+    static bool isWildcard(IdentifierConstPtr sender) { return !sender || sender->getType() == Identifier::WILDCARD_TYPE; }
+    static bool eraseOne(std::vector<Slot>& slots, const Slot& slot);
+    void updateMergedSlots(const Topic& topic);
+    void mergeSlots(Entry& entry, const Topic& topic) const;
+
+    std::unordered_map<Key, Entry, KeyHash> _exact;
+    std::unordered_map<Topic, std::vector<Slot>, TopicHash> _wildcard;
+    std::unordered_map<Topic, std::vector<IdentifierConstPtr>, TopicHash> _sendersByTopic; /** < The exact senders per topic */
+    static const std::vector<Slot> NO_SLOTS;
+};
+
+template <class Topic, class Slot, class TopicHash>
+const std::vector<Slot> IDDispatchIndex<Topic, Slot, TopicHash>::NO_SLOTS;
+
+template <class Topic, class Slot, class TopicHash>
+void IDDispatchIndex<Topic, Slot, TopicHash>::subscribe(IdentifierConstPtr sender, const Topic& topic, const Slot& slot)
+{
+    if (isWildcard(sender)) {
+        _wildcard[topic].push_back(slot);
+        updateMergedSlots(topic);
+        return;
+    }
+
+    auto entry = _exact.emplace(Key{sender, topic}, Entry());
+    if (entry.second) {
+        _sendersByTopic[topic].push_back(sender);
+    }
+    entry.first->second.exactSlots.push_back(slot);
+    mergeSlots(entry.first->second, topic);
+}
+
+template <class Topic, class Slot, class TopicHash>
+bool IDDispatchIndex<Topic, Slot, TopicHash>::unsubscribe(IdentifierConstPtr sender, const Topic& topic, const Slot& slot)
+{
+    if (isWildcard(sender)) {
+        auto wildcardEntry = _wildcard.find(topic);
+        if (wildcardEntry == _wildcard.end() || !eraseOne(wildcardEntry->second, slot)) {
+            return false;
+        }
+        if (wildcardEntry->second.empty()) {
+            _wildcard.erase(wildcardEntry);
+        }
+        updateMergedSlots(topic);
+        return true;
+    }
+
+    auto entry = _exact.find(Key{sender, topic});
+    if (entry == _exact.end() || !eraseOne(entry->second.exactSlots, slot)) {
+        return false;
+    }
+    if (!entry->second.exactSlots.empty()) {
+        mergeSlots(entry->second, topic);
+        return true;
+    }
+
+    _exact.erase(entry);
+    auto senders = _sendersByTopic.find(topic);
+    senders->second.erase(std::find(senders->second.begin(), senders->second.end(), sender));
+    if (senders->second.empty()) {
+        _sendersByTopic.erase(senders);
+    }
+    return true;
+}
+
+template <class Topic, class Slot, class TopicHash>
+const std::vector<Slot>& IDDispatchIndex<Topic, Slot, TopicHash>::lookup(IdentifierConstPtr sender, const Topic& topic) const
+{
+    if (!isWildcard(sender)) {
+        auto entry = _exact.find(Key{sender, topic});
+        if (entry != _exact.end()) {
+            return entry->second.slots;
+        }
+    }
+    auto wildcardEntry = _wildcard.find(topic);
+    if (wildcardEntry != _wildcard.end()) {
+        return wildcardEntry->second;
+    }
+    return NO_SLOTS;
+}
+
+template <class Topic, class Slot, class TopicHash>
+template <class Visitor>
+void IDDispatchIndex<Topic, Slot, TopicHash>::dispatch(IdentifierConstPtr sender, const Topic& topic, Visitor&& visitor) const
+{
+    for (const Slot& slot : lookup(sender, topic)) {
+        visitor(slot);
+    }
+}
+
+template <class Topic, class Slot, class TopicHash>
+bool IDDispatchIndex<Topic, Slot, TopicHash>::eraseOne(std::vector<Slot>& slots, const Slot& slot)
+{
+    auto it = std::find(slots.begin(), slots.end(), slot);
+    if (it == slots.end()) {
+        return false;
+    }
+    slots.erase(it);
+    return true;
+}
+
+template <class Topic, class Slot, class TopicHash>
+void IDDispatchIndex<Topic, Slot, TopicHash>::updateMergedSlots(const Topic& topic)
+{
+    auto senders = _sendersByTopic.find(topic);
+    if (senders == _sendersByTopic.end()) {
+        return;
+    }
+    for (IdentifierConstPtr sender : senders->second) {
+        mergeSlots(_exact.find(Key{sender, topic})->second, topic);
+    }
+}
+
+template <class Topic, class Slot, class TopicHash>
+void IDDispatchIndex<Topic, Slot, TopicHash>::mergeSlots(Entry& entry, const Topic& topic) const
+{
+    entry.slots = entry.exactSlots;
+    auto wildcardEntry = _wildcard.find(topic);
+    if (wildcardEntry != _wildcard.end()) {
+        entry.slots.insert(entry.slots.end(), wildcardEntry->second.begin(), wildcardEntry->second.end());
+    }
+}
+
+} // namespace essentials
@@ -4,7 +4,9 @@
 #include "essentials/WildcardID.h"
 
 #include <mutex>
-#include <unordered_set>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <bitset>
 
@@ -26,11 +28,60 @@ public:
      */
     const essentials::Identifier* getIDFromBytes(const uint8_t* idBytes, int idSize, uint8_t type = Identifier::UUID_TYPE);
     template <class Prototype>
-    const Identifier* getID(Prototype& idPrototype, uint8_t type = Identifier::UUID_TYPE);
+    const Identifier* getID(const Prototype& idPrototype, uint8_t type = Identifier::UUID_TYPE);
+    /**
+     * Decodes an ID written by Identifier::serializeTo() and returns the
+     * corresponding managed ID, without allocating if it is already known.
+     * @param bytesRead Is set to the number of consumed bytes, 0 on failure.
+     * @return The ID, or nullptr if the buffer does not hold a complete ID.
+     */
+    const Identifier* deserializeID(const uint8_t* buffer, size_t bufferSize, size_t& bytesRead);
+    /**
+     * Decodes IDs written by Identifier::serializeAll() until the buffer is
+     * consumed and writes them to the given output iterator.
+     * @return The number of consumed bytes. It is less than bufferSize, if the buffer ends with an incomplete ID.
+     */
+    template <class OutputIterator>
+    size_t deserializeAll(const uint8_t* buffer, size_t bufferSize, OutputIterator out);
     const Identifier* generateID(int size = 16);
     const Identifier* getWildcardID() const;
+
+    /**
+     * Builds the byte-wise ordered index over all IDs managed so far and keeps
+     * it up to date for every ID created afterwards. Calling it more than once
+     * has no effect. The prefix and range queries below enable the index on
+     * their first call, so this is only needed to pay the build cost up front.
+     */
+    void enableOrderedIndex();
+    /**
+     * Calls the visitor for every ID whose bytes start with the given prefix,
+     * in byte-wise lexicographic order. The wildcard ID is never visited.
+     *
+     * The visitor is called while the manager is locked, so it must not call
+     * back into this IDManager.
+     */
+    template <class Visitor>
+    void forEachWithPrefix(const uint8_t* prefix, int prefixSize, Visitor&& visitor);
+    /**
+     * Calls the visitor for every ID in the half-open byte-wise range [low, high),
+     * in ascending order. Passing nullptr as highBytes scans to the last ID.
+     *
+     * The visitor is called while the manager is locked, so it must not call
+     * back into this IDManager.
+     */
+    template <class Visitor>
+    void forEachInRange(const uint8_t* lowBytes, int lowSize, const uint8_t* highBytes, int highSize, Visitor&& visitor);
+
 private:
-    std::unordered_set<const Identifier*, essentials::IdentifierHash, essentials::IdentifierEqualsComparator> ids;
+    void enableOrderedIndexUnlocked();
+
+    /**
+     * Keyed by Identifier::hashBytes(), so that lookups can hash and compare the
+     * raw bytes directly, without constructing a temporary Identifier.
+     */
+    std::unordered_multimap<std::size_t, const Identifier*> ids;
+    std::set<const Identifier*, essentials::IdentifierBytewiseComparator> orderedIds; /** < Only maintained after enableOrderedIndex() */
+    bool orderedIndexEnabled;
     std::mutex idsMutex;
     WildcardID* wildcardId;
 };
@@ -43,16 +94,54 @@ private:
  * a pointer to a corresponding ID object.
  */
 template <class Prototype>
-const Identifier* IDManager::getID(Prototype& idPrototype, uint8_t type)
+const Identifier* IDManager::getID(const Prototype& idPrototype, uint8_t type)
+{
+    static_assert(std::is_trivially_copyable<Prototype>::value, "IDs can only be created from trivially copyable prototypes!");
+    // the object representation is hashed and compared in place, i.e., little-endian on little-endian machines
+    return this->getIDFromBytes(reinterpret_cast<const uint8_t*>(&idPrototype), sizeof(Prototype), type);
+}
+
+template <class OutputIterator>
+size_t IDManager::deserializeAll(const uint8_t* buffer, size_t bufferSize, OutputIterator out)
+{
+    size_t offset = 0;
+    while (offset < bufferSize) {
+        size_t bytesRead;
+        const Identifier* id = this->deserializeID(buffer + offset, bufferSize - offset, bytesRead);
+        if (bytesRead == 0) {
+            break;
+        }
+        *out++ = id;
+        offset += bytesRead;
+    }
+    return offset;
+}
+
+template <class Visitor>
+void IDManager::forEachWithPrefix(const uint8_t* prefix, int prefixSize, Visitor&& visitor)
 {
-    // little-endian encoding
-    std::vector<uint8_t> idByteVector;
-    // TODO: replace with memcpy or std copy
-    for (int i = 0; i < static_cast<int>(sizeof(Prototype)); i++) {
-        idByteVector.push_back(*(((uint8_t*) &idPrototype) + i));
+    const Identifier probe(prefix, prefixSize);
+    std::lock_guard<std::mutex> guard(idsMutex);
+    enableOrderedIndexUnlocked();
+    for (auto it = orderedIds.lower_bound(&probe); it != orderedIds.end() && (*it)->hasPrefix(prefix, prefixSize); ++it) {
+        visitor(*it);
     }
+}
 
-    return this->getIDFromBytes(idByteVector.data(), idByteVector.size(), type);
+template <class Visitor>
+void IDManager::forEachInRange(const uint8_t* lowBytes, int lowSize, const uint8_t* highBytes, int highSize, Visitor&& visitor)
+{
+    const Identifier low(lowBytes, lowSize);
+    std::lock_guard<std::mutex> guard(idsMutex);
+    enableOrderedIndexUnlocked();
+    auto end = orderedIds.end();
+    if (highBytes != nullptr) {
+        const Identifier high(highBytes, highSize);
+        end = orderedIds.lower_bound(&high);
+    }
+    for (auto it = orderedIds.lower_bound(&low); it != end; ++it) {
+        visitor(*it);
+    }
 }
 
 } // namespace essentials
@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include <type_traits>
 #include <vector>
 #include <bitset>
 
@@ -31,6 +32,40 @@ public:
     virtual std::vector<uint8_t> toByteVector() const;
     virtual std::size_t hash() const;
     virtual uint8_t getType() const;
+    bool hasPrefix(const uint8_t* prefix, int prefixSize) const;
+    bool equalsBytes(const uint8_t* idBytes, int idSize) const;
+
+    /**
+     * Hashes the given bytes exactly like hash() hashes the bytes of an ID,
+     * so IDs can be looked up without constructing them first.
+     */
+    static std::size_t hashBytes(const uint8_t* idBytes, int idSize);
+
+    /**
+     * The number of bytes serializeTo() writes for this ID, i.e., the type byte,
+     * the 32 bit little-endian length and the ID bytes.
+     */
+    size_t getSerializedSize() const;
+    /**
+     * Writes the type byte, the length and the ID bytes into the given buffer.
+     * @return The number of bytes written, or 0 if the buffer is too small.
+     */
+    size_t serializeTo(uint8_t* buffer, size_t bufferSize) const;
+    /**
+     * Writes all IDs of the given range back to back into the buffer, with a single
+     * bounds check for the whole range. The range may hold Identifier pointers or
+     * IdentifierConstPtrs.
+     * @return The number of bytes written, or 0 if the buffer is too small for all IDs.
+     */
+    template <class Iterator>
+    static size_t serializeAll(Iterator begin, Iterator end, uint8_t* buffer, size_t bufferSize);
+    /**
+     * Reads the header written by serializeTo().
+     * @return False, if the buffer does not hold a complete serialized ID.
+     */
+    static bool readSerializedHeader(const uint8_t* buffer, size_t bufferSize, uint8_t& type, uint32_t& idSize);
+
+    static const size_t SERIALIZED_HEADER_SIZE = 5;
 
     friend std::ostream& operator<<(std::ostream& os, const essentials::Identifier& obj)
     {
@@ -61,19 +96,35 @@ public:
 
 private:
     template <class Prototype>
-    void setID(Prototype& idPrototype);
+    void setID(const Prototype& idPrototype);
+    size_t serializeUnchecked(uint8_t* buffer) const;
     std::vector<uint8_t> _id;
     const uint8_t _type;
 };
 
 template <class Prototype>
-void Identifier::setID(Prototype& prototypeID)
+void Identifier::setID(const Prototype& prototypeID)
+{
+    static_assert(std::is_trivially_copyable<Prototype>::value, "IDs can only be created from trivially copyable prototypes!");
+    // the object representation is taken as is, i.e., little-endian on little-endian machines
+    const uint8_t* prototypeBytes = reinterpret_cast<const uint8_t*>(&prototypeID);
+    _id.assign(prototypeBytes, prototypeBytes + sizeof(Prototype));
+}
+
+template <class Iterator>
+size_t Identifier::serializeAll(Iterator begin, Iterator end, uint8_t* buffer, size_t bufferSize)
 {
-    // little-endian encoding
-    // TODO: replace with memcpy or std copy
-    for (int i = 0; i < static_cast<int>(sizeof(Prototype)); i++) {
-        _id.push_back(*(((uint8_t*)&prototypeID) + i));
+    size_t requiredSize = 0;
+    for (Iterator it = begin; it != end; ++it) {
+        requiredSize += SERIALIZED_HEADER_SIZE + (*it)->getSize();
     }
+    if (requiredSize > bufferSize) {
+        return 0;
+    }
+    for (Iterator it = begin; it != end; ++it) {
+        buffer += (*it)->serializeUnchecked(buffer);
+    }
+    return requiredSize;
 }
 
 struct IdentifierComparator
@@ -81,6 +132,16 @@ struct IdentifierComparator
     bool operator()(const Identifier* a, const Identifier* b) const { return *a < *b; }
 };
 
+/**
+ * Orders identifiers lexicographically by their bytes, so that all identifiers
+ * sharing a common prefix are adjacent. In contrast, IdentifierComparator orders
+ * by size first.
+ */
+struct IdentifierBytewiseComparator
+{
+    bool operator()(const Identifier* a, const Identifier* b) const;
+};
+
 struct IdentifierEqualsComparator
 {
     bool operator()(const Identifier* const a, const Identifier* b) const { return *a == *b; }
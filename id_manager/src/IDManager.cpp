@@ -4,15 +4,17 @@
 
 namespace essentials
 {
-IDManager::IDManager() {
+IDManager::IDManager()
+        : orderedIndexEnabled(false)
+{
     this->wildcardId = new WildcardID(nullptr, 0);
-    this->ids.insert(this->wildcardId);
 }
 IDManager::~IDManager()
 {
-    for (auto& id : this->ids) {
-        delete id;
+    for (auto& entry : this->ids) {
+        delete entry.second;
     }
+    delete this->wildcardId;
 }
 
 const essentials::Identifier* IDManager::getIDFromBytes(const uint8_t *idBytes, int idSize, uint8_t type)
@@ -26,18 +28,38 @@ const essentials::Identifier* IDManager::getIDFromBytes(const uint8_t *idBytes,
         return nullptr;
     }
 
-    // create tmpID for lookup the ID
-    const essentials::Identifier* tmpID = new essentials::Identifier(idBytes, idSize, type);
+    std::size_t hash = essentials::Identifier::hashBytes(idBytes, idSize);
 
     // make the manager thread-safe
     std::lock_guard<std::mutex> guard(idsMutex);
 
-    // lookup the ID and insert it, if not available, yet
-    auto entry = this->ids.insert(tmpID);
-    if (!entry.second) { // delete tmpID if already present in IDs
-        delete tmpID;
+    // lookup the ID by its raw bytes, so nothing is allocated if it is already present
+    auto range = this->ids.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->equalsBytes(idBytes, idSize)) {
+            return it->second;
+        }
+    }
+
+    // insert it, as it is not available, yet
+    const essentials::Identifier* newID = new essentials::Identifier(idBytes, idSize, type);
+    this->ids.emplace(hash, newID);
+    if (orderedIndexEnabled) {
+        this->orderedIds.insert(newID);
+    }
+    return newID;
+}
+
+const essentials::Identifier* IDManager::deserializeID(const uint8_t* buffer, size_t bufferSize, size_t& bytesRead)
+{
+    uint8_t type;
+    uint32_t idSize;
+    if (!essentials::Identifier::readSerializedHeader(buffer, bufferSize, type, idSize)) {
+        bytesRead = 0;
+        return nullptr;
     }
-    return *(entry.first);
+    bytesRead = essentials::Identifier::SERIALIZED_HEADER_SIZE + idSize;
+    return this->getIDFromBytes(buffer + essentials::Identifier::SERIALIZED_HEADER_SIZE, idSize, type);
 }
 
 const essentials::Identifier* IDManager::generateID(int size)
@@ -62,4 +84,21 @@ const essentials::Identifier* IDManager::getWildcardID() const {
     return this->wildcardId;
 }
 
+void IDManager::enableOrderedIndex()
+{
+    std::lock_guard<std::mutex> guard(idsMutex);
+    enableOrderedIndexUnlocked();
+}
+
+void IDManager::enableOrderedIndexUnlocked()
+{
+    if (orderedIndexEnabled) {
+        return;
+    }
+    for (auto& entry : this->ids) {
+        this->orderedIds.insert(entry.second);
+    }
+    orderedIndexEnabled = true;
+}
+
 } // namespace essentials
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "essentials/Identifier.h"
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 namespace essentials
 {
 
+const size_t Identifier::SERIALIZED_HEADER_SIZE;
+
 Identifier::Identifier()
         : _type(UUID_TYPE)
 {
@@ -23,11 +27,9 @@ Identifier::Identifier(const std::vector<uint8_t>& idBytes)
 }
 
 Identifier::Identifier(const uint8_t* idBytes, int idSize, uint8_t type)
-        : _type(type)
+        : _id(idBytes, idBytes + idSize)
+        , _type(type)
 {
-    for (int i = 0; i < idSize; i++) {
-        _id.push_back(idBytes[i]);
-    }
 }
 
 Identifier::~Identifier() = default;
@@ -73,6 +75,19 @@ bool Identifier::operator>(const Identifier& other) const
     return other < *this;
 }
 
+bool Identifier::hasPrefix(const uint8_t* prefix, int prefixSize) const
+{
+    if (prefixSize > static_cast<int>(_id.size())) {
+        return false;
+    }
+    return prefixSize == 0 || memcmp(_id.data(), prefix, prefixSize) == 0;
+}
+
+bool Identifier::equalsBytes(const uint8_t* idBytes, int idSize) const
+{
+    return static_cast<int>(_id.size()) == idSize && (idSize == 0 || memcmp(_id.data(), idBytes, idSize) == 0);
+}
+
 Identifier& Identifier::operator=(const std::vector<uint8_t>& idBytes)
 {
     _id = idBytes;
@@ -89,18 +104,16 @@ Identifier::operator uint64_t() const
         throw ss.str();
     }
 
-    // Determine the endianness
-    constexpr short n = 1;
-    bool isLittleEndian = *((char*) (&n)) == 1;
-
-    // moving data
+    // moving data, the endianness is determined at compile time
     uint64_t out = 0;
-    if (isLittleEndian) {
-        std::copy(_id.begin(), _id.end(), (uint8_t*) (&out));
-    } else {
-        int offset = static_cast<int>(sizeof(long long) - _id.size());
-        std::copy(_id.begin(), _id.end(), (uint8_t*) (&out) + offset);
+    if (_id.empty()) {
+        return out;
     }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(&out, _id.data(), _id.size());
+#else
+    memcpy(reinterpret_cast<uint8_t*>(&out) + sizeof(uint64_t) - _id.size(), _id.data(), _id.size());
+#endif
     return out;
 }
 
@@ -119,6 +132,45 @@ std::vector<uint8_t> Identifier::toByteVector() const
     return _id;
 }
 
+size_t Identifier::getSerializedSize() const
+{
+    return SERIALIZED_HEADER_SIZE + _id.size();
+}
+
+size_t Identifier::serializeTo(uint8_t* buffer, size_t bufferSize) const
+{
+    if (getSerializedSize() > bufferSize) {
+        return 0;
+    }
+    return serializeUnchecked(buffer);
+}
+
+size_t Identifier::serializeUnchecked(uint8_t* buffer) const
+{
+    // type byte and little-endian length, independent of the host byte order
+    uint32_t idSize = static_cast<uint32_t>(_id.size());
+    buffer[0] = getType();
+    buffer[1] = static_cast<uint8_t>(idSize);
+    buffer[2] = static_cast<uint8_t>(idSize >> 8);
+    buffer[3] = static_cast<uint8_t>(idSize >> 16);
+    buffer[4] = static_cast<uint8_t>(idSize >> 24);
+    if (idSize > 0) {
+        memcpy(buffer + SERIALIZED_HEADER_SIZE, _id.data(), idSize);
+    }
+    return SERIALIZED_HEADER_SIZE + idSize;
+}
+
+bool Identifier::readSerializedHeader(const uint8_t* buffer, size_t bufferSize, uint8_t& type, uint32_t& idSize)
+{
+    if (bufferSize < SERIALIZED_HEADER_SIZE) {
+        return false;
+    }
+    type = buffer[0];
+    idSize = static_cast<uint32_t>(buffer[1]) | (static_cast<uint32_t>(buffer[2]) << 8) | (static_cast<uint32_t>(buffer[3]) << 16) |
+             (static_cast<uint32_t>(buffer[4]) << 24);
+    return idSize <= bufferSize - SERIALIZED_HEADER_SIZE;
+}
+
 /**
  * See:
  * https://en.wikipedia.org/wiki/MurmurHash
@@ -126,14 +178,21 @@ std::vector<uint8_t> Identifier::toByteVector() const
  */
 std::size_t Identifier::hash() const
 {
-    const uint8_t* key = _id.data();
-    int len = _id.size();
+    return hashBytes(_id.data(), _id.size());
+}
+
+std::size_t Identifier::hashBytes(const uint8_t* idBytes, int idSize)
+{
+    const uint8_t* key = idBytes;
+    int len = idSize;
     uint32_t h = 13;
     if (len > 3) {
-        const uint32_t* key_x4 = (const uint32_t*) key;
-        size_t i = _id.size() >> 2;
+        const uint8_t* key_x4 = key;
+        size_t i = len >> 2;
         do {
-            uint32_t k = *key_x4++;
+            uint32_t k;
+            memcpy(&k, key_x4, sizeof(uint32_t)); // unaligned load
+            key_x4 += sizeof(uint32_t);
             k *= 0xcc9e2d51;
             k = (k << 15) | (k >> 17);
             k *= 0x1b873593;
@@ -141,7 +200,7 @@ std::size_t Identifier::hash() const
             h = (h << 13) | (h >> 19);
             h = (h * 5) + 0xe6546b64;
         } while (--i);
-        key = (const uint8_t*) key_x4;
+        key = key_x4;
     }
     if (len & 3) {
         size_t i = len & 3;
@@ -165,4 +224,14 @@ std::size_t Identifier::hash() const
     return h;
 }
 
+bool IdentifierBytewiseComparator::operator()(const Identifier* a, const Identifier* b) const
+{
+    size_t common = std::min(a->getSize(), b->getSize());
+    int cmp = common == 0 ? 0 : memcmp(a->getRaw(), b->getRaw(), common);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return a->getSize() < b->getSize();
+}
+
 } /* namespace essentials */
@@ -1,5 +1,4 @@
 #include "essentials/WildcardID.h"
-#include <typeinfo>
 
 namespace essentials
 {
@@ -13,24 +12,13 @@ WildcardID::~WildcardID() {}
 
 bool WildcardID::operator==(const essentials::Identifier& other) const
 {
-    try {
-        dynamic_cast<const WildcardID&>(other);
-    } catch (const std::bad_cast& e) {
-        return false;
-    }
-
-    return true;
+    // pointer cast, so comparing with a normal ID does not throw std::bad_cast
+    return dynamic_cast<const WildcardID*>(&other) != nullptr;
 }
 
 bool WildcardID::operator!=(const essentials::Identifier& other) const
 {
-    try {
-        dynamic_cast<const WildcardID&>(other);
-    } catch (const std::bad_cast& e) {
-        return true;
-    }
-
-    return false;
+    return dynamic_cast<const WildcardID*>(&other) == nullptr;
 }
 
 bool WildcardID::operator<(const essentials::Identifier& other) const
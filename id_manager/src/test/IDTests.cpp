@@ -1,9 +1,11 @@
+#include <essentials/IDDispatchIndex.h>
 #include <essentials/Identifier.h>
 #include <essentials/IdentifierConstPtr.h>
 #include <essentials/IDManager.h>
 #include <essentials/WildcardID.h>
 
 #include <gtest/gtest.h>
+#include <iterator>
 #include <vector>
 
 TEST(Identifier, ConstructorCopiesBytes)
@@ -124,6 +126,52 @@ TEST(BroadCastID, EqualWithBroadcastID)
     ASSERT_TRUE(*broadcastID1 == *broadcastID2);
 }
 
+TEST(IDDispatchIndex, ExactSlotsPrecedeWildcardSlots)
+{
+    essentials::IDManager idManager;
+    essentials::IdentifierConstPtr robot1 = idManager.getID<int>(1);
+    essentials::IdentifierConstPtr robot2 = idManager.getID<int>(2);
+    essentials::IDDispatchIndex<int, int> index;
+
+    index.subscribe(robot1, 7, 10);
+    index.subscribe(idManager.getWildcardID(), 7, 20);
+    index.subscribe(robot1, 8, 30);
+
+    ASSERT_EQ(std::vector<int>({10, 20}), index.lookup(robot1, 7));
+    ASSERT_EQ(std::vector<int>({20}), index.lookup(robot2, 7));
+    ASSERT_EQ(std::vector<int>({30}), index.lookup(robot1, 8));
+    ASSERT_TRUE(index.lookup(robot2, 8).empty());
+
+    ASSERT_TRUE(index.unsubscribe(idManager.getWildcardID(), 7, 20));
+    ASSERT_FALSE(index.unsubscribe(idManager.getWildcardID(), 7, 20));
+    ASSERT_EQ(std::vector<int>({10}), index.lookup(robot1, 7));
+    ASSERT_TRUE(index.lookup(robot2, 7).empty());
+
+    ASSERT_TRUE(index.unsubscribe(robot1, 7, 10));
+    ASSERT_TRUE(index.unsubscribe(robot1, 8, 30));
+    ASSERT_TRUE(index.empty());
+}
+
+TEST(IDDispatchIndex, NullSenderIsTheWildcard)
+{
+    essentials::IDManager idManager;
+    essentials::IdentifierConstPtr robot1 = idManager.getID<int>(1);
+    essentials::IDDispatchIndex<int, int> index;
+
+    index.subscribe(essentials::IdentifierConstPtr(), 7, 20);
+    index.subscribe(robot1, 7, 10);
+
+    ASSERT_EQ(std::vector<int>({20}), index.lookup(essentials::IdentifierConstPtr(), 7));
+    ASSERT_EQ(std::vector<int>({20}), index.lookup(idManager.getWildcardID(), 7));
+    ASSERT_EQ(std::vector<int>({10, 20}), index.lookup(robot1, 7));
+    int calls = 0;
+    index.dispatch(essentials::IdentifierConstPtr(), 7, [&calls](int) { calls++; });
+    ASSERT_EQ(1, calls);
+
+    ASSERT_TRUE(index.unsubscribe(essentials::IdentifierConstPtr(), 7, 20));
+    ASSERT_EQ(std::vector<int>({10}), index.lookup(robot1, 7));
+}
+
 TEST(IdentifierFactory, GenerateIDsOfVariousLength)
 {
     essentials::IDManager factory;
@@ -165,6 +213,24 @@ TEST(IdentifierManager, CreateIDsFromIntegralTypes)
     ASSERT_TRUE(*intId5 == *referenceId5);
 }
 
+TEST(IdentifierManager, CreateIDsFromTriviallyCopyableTypes)
+{
+    struct FleetRobot
+    {
+        uint8_t fleet;
+        uint8_t robot[3];
+    };
+
+    essentials::IDManager idManager;
+    FleetRobot prototype{7, {1, 2, 3}};
+    auto structId = idManager.getID(prototype);
+    uint8_t idBytes[] = {7, 1, 2, 3};
+
+    ASSERT_EQ(structId, idManager.getIDFromBytes(idBytes, sizeof(idBytes)));
+    ASSERT_EQ(idManager.getID<uint64_t>(42), idManager.getID<uint64_t>(42));
+    ASSERT_EQ(42u, static_cast<uint64_t>(*idManager.getID<uint64_t>(42)));
+}
+
 TEST(IdentifierManager, GuarenteeSingleEntities)
 {
     essentials::IDManager* idManager = new essentials::IDManager();
@@ -192,6 +258,63 @@ TEST(IdentifierManager, GenerateIDsOfVariousLength)
     ASSERT_EQ(id18->getSize(), 18);
 }
 
+TEST(IdentifierManager, SerializeAndDeserializeIDs)
+{
+    essentials::IDManager idManager;
+    std::vector<essentials::IdentifierConstPtr> agents = {idManager.generateID(16), idManager.getID<int>(5), idManager.getWildcardID()};
+
+    uint8_t tooSmall[8];
+    ASSERT_EQ(0u, essentials::Identifier::serializeAll(agents.begin(), agents.end(), tooSmall, sizeof(tooSmall)));
+
+    uint8_t buffer[64];
+    size_t written = essentials::Identifier::serializeAll(agents.begin(), agents.end(), buffer, sizeof(buffer));
+    ASSERT_EQ(3 * essentials::Identifier::SERIALIZED_HEADER_SIZE + 16 + sizeof(int), written);
+
+    std::vector<essentials::IdentifierConstPtr> decoded;
+    ASSERT_EQ(written, idManager.deserializeAll(buffer, written, std::back_inserter(decoded)));
+    ASSERT_EQ(agents, decoded);
+
+    size_t bytesRead;
+    ASSERT_EQ(nullptr, idManager.deserializeID(buffer, essentials::Identifier::SERIALIZED_HEADER_SIZE + 15, bytesRead));
+    ASSERT_EQ(0u, bytesRead);
+}
+
+TEST(IdentifierManager, ForEachWithPrefixVisitsMatchesInOrder)
+{
+    essentials::IDManager idManager;
+    std::vector<std::vector<uint8_t>> idBytes = {{2, 7}, {1, 3, 1}, {1, 2}, {2}, {1, 2, 9}, {0, 1}};
+    for (auto& bytes : idBytes) {
+        idManager.getIDFromBytes(bytes.data(), bytes.size());
+    }
+    // created after the index has been built
+    uint8_t lateBytes[] = {1, 2, 5};
+    idManager.enableOrderedIndex();
+    idManager.getIDFromBytes(lateBytes, 3);
+
+    std::vector<std::vector<uint8_t>> visited;
+    uint8_t prefix[] = {1};
+    idManager.forEachWithPrefix(prefix, 1, [&](const essentials::Identifier* id) { visited.push_back(id->toByteVector()); });
+
+    std::vector<std::vector<uint8_t>> expected = {{1, 2}, {1, 2, 5}, {1, 2, 9}, {1, 3, 1}};
+    ASSERT_EQ(expected, visited);
+}
+
+TEST(IdentifierManager, ForEachInRangeIsHalfOpen)
+{
+    essentials::IDManager idManager;
+    for (uint8_t i = 0; i < 10; i++) {
+        idManager.getIDFromBytes(&i, 1);
+    }
+
+    std::vector<uint8_t> visited;
+    uint8_t low = 3;
+    uint8_t high = 6;
+    idManager.forEachInRange(&low, 1, &high, 1, [&](const essentials::Identifier* id) { visited.push_back(id->getRaw()[0]); });
+
+    std::vector<uint8_t> expected = {3, 4, 5};
+    ASSERT_EQ(expected, visited);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);